@@ -0,0 +1,22 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderReloadHandover.h"
+
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, RiderReloadHandover);
+
+namespace RiderReloadHandover
+{
+	static TArray<uint8> HandoverBlob;
+
+	void Store(const TArray<uint8>& Blob)
+	{
+		HandoverBlob = Blob;
+	}
+
+	TArray<uint8> Take()
+	{
+		return MoveTemp(HandoverBlob);
+	}
+}
@@ -0,0 +1,18 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Carries state from a RiderSourceCodeAccess instance that is unloaded for a reload to the instance replacing it.
+ * Lives in its own module that is never reloaded, so the blob stays in a plain static that outlives the reloaded binary.
+ * Both calls come from module startup and shutdown on the game thread.
+ */
+namespace RiderReloadHandover
+{
+	RIDERRELOADHANDOVER_API void Store(const TArray<uint8>& Blob);
+
+	/** Blob stored by the previous instance, empty on a cold start. Taking it clears it */
+	RIDERRELOADHANDOVER_API TArray<uint8> Take();
+}
@@ -0,0 +1,13 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+namespace UnrealBuildTool.Rules
+{
+	public class RiderReloadHandover : ModuleRules
+	{
+		public RiderReloadHandover(ReadOnlyTargetRules Target) : base(Target)
+		{
+			PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+			PublicDependencyModuleNames.Add("Core");
+		}
+	}
+}
@@ -0,0 +1,280 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderCallTrace.h"
+
+#include "RiderSourceCodeAccessSettings.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRiderCallTrace, Log, All);
+
+TAtomic<bool> FRiderCallTrace::bRecording { false };
+
+namespace RiderCallTrace
+{
+	static const uint32 Magic = 0x52534354; // 'RSCT'
+
+	/** Idle gaps are clamped to this, a replay has no use for waiting longer */
+	static const int64 MaxDeltaMicroseconds = 3600ll * 1000000ll;
+
+	struct FRecording
+	{
+		FString Path;
+		TMap<FString, uint32> StringIndices;
+		TArray<FString> Strings;
+
+		/** Packed calls, each: kind, microseconds since the previous call, then its arguments */
+		TArray<uint8> Calls;
+		uint32 NumCalls = 0;
+
+		double StartTime = 0.0;
+		int64 LastMicroseconds = 0;
+	};
+
+	static FCriticalSection RecordingCriticalSection;
+	static TUniquePtr<FRecording> Recording;
+
+	static bool HasPaths(FRiderCallTrace::ECall Call)
+	{
+		return Call == FRiderCallTrace::ECall::OpenFileAtLine || Call == FRiderCallTrace::ECall::OpenSourceFiles || Call == FRiderCallTrace::ECall::AddSourceFiles;
+	}
+
+	static void WriteStrings(FArchive& Writer, FRecording& InRecording, TArrayView<const FString> Strings)
+	{
+		uint32 Num = Strings.Num();
+		Writer.SerializeIntPacked(Num);
+		for (const FString& String : Strings)
+		{
+			uint32 Index = InRecording.StringIndices.FindOrAdd(String, InRecording.Strings.Num());
+			if (Index == static_cast<uint32>(InRecording.Strings.Num()))
+			{
+				InRecording.Strings.Add(String);
+			}
+			Writer.SerializeIntPacked(Index);
+		}
+	}
+
+	static bool ReadStrings(FArchive& Reader, const TArray<FString>& Strings, TArray<FString>& OutStrings)
+	{
+		uint32 Num = 0;
+		Reader.SerializeIntPacked(Num);
+		if (Reader.IsError() || Num > static_cast<uint32>(Reader.TotalSize())) return false;
+
+		OutStrings.Reserve(Num);
+		for (uint32 Index = 0; Index < Num; Index++)
+		{
+			uint32 StringIndex = 0;
+			Reader.SerializeIntPacked(StringIndex);
+			if (Reader.IsError() || !Strings.IsValidIndex(StringIndex)) return false;
+			OutStrings.Add(Strings[StringIndex]);
+		}
+		return true;
+	}
+
+	static bool Save(const FRecording& InRecording)
+	{
+		TArray<uint8> Buffer;
+		FMemoryWriter Writer(Buffer);
+		uint32 FileMagic = Magic;
+		int32 FileFormatVersion = FRiderCallTrace::FormatVersion;
+		TArray<FString> Strings = InRecording.Strings;
+		uint32 NumCalls = InRecording.NumCalls;
+		TArray<uint8> Calls = InRecording.Calls;
+		Writer << FileMagic << FileFormatVersion << Strings << NumCalls << Calls;
+
+		// Write aside and move into place, so a trace being replayed is never read half written
+		const FString TempPath = InRecording.Path + TEXT(".") + FGuid::NewGuid().ToString();
+		if (!FFileHelper::SaveArrayToFile(Buffer, *TempPath)) return false;
+		if (!IFileManager::Get().Move(*InRecording.Path, *TempPath, true, true))
+		{
+			IFileManager::Get().Delete(*TempPath);
+			return false;
+		}
+		return true;
+	}
+}
+
+void FRiderCallTrace::Initialize()
+{
+	const FString Path = FRiderSourceCodeAccessSettings::Get().CallTracePath;
+	if (!Path.IsEmpty())
+	{
+		Start(Path);
+	}
+}
+
+void FRiderCallTrace::Shutdown()
+{
+	if (IsRecording())
+	{
+		Stop();
+	}
+}
+
+void FRiderCallTrace::Start(const FString& Path)
+{
+	using namespace RiderCallTrace;
+
+	// A trace still recording is written before the new one starts, not discarded
+	if (IsRecording())
+	{
+		UE_LOG(LogRiderCallTrace, Log, TEXT("Stopping the running call trace before starting a new one"));
+		Stop();
+	}
+
+	FScopeLock Lock(&RecordingCriticalSection);
+	Recording = MakeUnique<FRecording>();
+	Recording->Path = FPaths::ConvertRelativePathToFull(Path);
+	bRecording = true;
+	UE_LOG(LogRiderCallTrace, Log, TEXT("Recording accessor calls to %s"), *Recording->Path);
+}
+
+bool FRiderCallTrace::Stop()
+{
+	using namespace RiderCallTrace;
+
+	TUniquePtr<FRecording> Finished;
+	{
+		FScopeLock Lock(&RecordingCriticalSection);
+		bRecording = false;
+		Finished = MoveTemp(Recording);
+	}
+	if (!Finished.IsValid()) return false;
+
+	if (!Save(*Finished))
+	{
+		UE_LOG(LogRiderCallTrace, Warning, TEXT("Couldn't write the call trace to %s"), *Finished->Path);
+		return false;
+	}
+	UE_LOG(LogRiderCallTrace, Log, TEXT("Wrote %u calls (%d bytes of calls, %d strings) to %s"),
+		Finished->NumCalls, Finished->Calls.Num(), Finished->Strings.Num(), *Finished->Path);
+	return true;
+}
+
+void FRiderCallTrace::Append(ECall Call, TArrayView<const FString> Paths, TArrayView<const FString> Modules, int32 Line, int32 Column)
+{
+	using namespace RiderCallTrace;
+
+	const double Now = FPlatformTime::Seconds();
+	FScopeLock Lock(&RecordingCriticalSection);
+	if (!Recording.IsValid()) return;
+
+	if (Recording->NumCalls == 0)
+	{
+		Recording->StartTime = Now;
+	}
+	const int64 Microseconds = FMath::Max<int64>(static_cast<int64>((Now - Recording->StartTime) * 1000000.0), Recording->LastMicroseconds);
+	uint32 DeltaMicroseconds = static_cast<uint32>(FMath::Min<int64>(Microseconds - Recording->LastMicroseconds, MaxDeltaMicroseconds));
+	Recording->LastMicroseconds = Microseconds;
+
+	FMemoryWriter Writer(Recording->Calls, false, true);
+	uint8 CallByte = static_cast<uint8>(Call);
+	Writer << CallByte;
+	Writer.SerializeIntPacked(DeltaMicroseconds);
+	if (HasPaths(Call))
+	{
+		WriteStrings(Writer, *Recording, Paths);
+	}
+	if (Call == ECall::AddSourceFiles)
+	{
+		WriteStrings(Writer, *Recording, Modules);
+	}
+	if (Call == ECall::OpenFileAtLine)
+	{
+		uint32 PackedLine = FMath::Max(Line, 0);
+		uint32 PackedColumn = FMath::Max(Column, 0);
+		Writer.SerializeIntPacked(PackedLine);
+		Writer.SerializeIntPacked(PackedColumn);
+	}
+	Recording->NumCalls++;
+}
+
+TOptional<TArray<FRiderCallTrace::FCall>> FRiderCallTrace::Load(const FString& Path)
+{
+	TArray<uint8> Buffer;
+	if (!FFileHelper::LoadFileToArray(Buffer, *Path, FILEREAD_Silent)) return {};
+
+	FMemoryReader Reader(Buffer);
+	uint32 FileMagic = 0;
+	int32 FileFormatVersion = 0;
+	Reader << FileMagic << FileFormatVersion;
+	if (FileMagic != RiderCallTrace::Magic || FileFormatVersion != FormatVersion) return {};
+
+	TArray<FString> Strings;
+	uint32 NumCalls = 0;
+	TArray<uint8> CallsBuffer;
+	Reader << Strings << NumCalls << CallsBuffer;
+	if (Reader.IsError()) return {};
+
+	// Every call takes at least two bytes, which also bounds the reservation below for a corrupt count
+	if (NumCalls > static_cast<uint32>(CallsBuffer.Num()) / 2) return {};
+
+	TArray<FCall> Calls;
+	Calls.Reserve(NumCalls);
+	FMemoryReader CallsReader(CallsBuffer);
+	uint64 Microseconds = 0;
+	for (uint32 Index = 0; Index < NumCalls; Index++)
+	{
+		FCall& Call = Calls.AddDefaulted_GetRef();
+		uint8 CallByte = 0;
+		uint32 DeltaMicroseconds = 0;
+		CallsReader << CallByte;
+		CallsReader.SerializeIntPacked(DeltaMicroseconds);
+		if (CallsReader.IsError() || CallByte >= static_cast<uint8>(ECall::Num)) return {};
+
+		Call.Call = static_cast<ECall>(CallByte);
+		Microseconds += DeltaMicroseconds;
+		Call.Seconds = Microseconds / 1000000.0;
+		if (RiderCallTrace::HasPaths(Call.Call) && !RiderCallTrace::ReadStrings(CallsReader, Strings, Call.Paths)) return {};
+		if (Call.Call == ECall::AddSourceFiles && !RiderCallTrace::ReadStrings(CallsReader, Strings, Call.Modules)) return {};
+		if (Call.Call == ECall::OpenFileAtLine)
+		{
+			uint32 PackedLine = 0;
+			uint32 PackedColumn = 0;
+			CallsReader.SerializeIntPacked(PackedLine);
+			CallsReader.SerializeIntPacked(PackedColumn);
+			if (CallsReader.IsError() || Call.Paths.Num() != 1) return {};
+
+			Call.Line = static_cast<int32>(FMath::Min<uint32>(PackedLine, MAX_int32));
+			Call.Column = static_cast<int32>(FMath::Min<uint32>(PackedColumn, MAX_int32));
+		}
+	}
+	return Calls;
+}
+
+const TCHAR* FRiderCallTrace::GetCallName(ECall Call)
+{
+	switch (Call)
+	{
+		case ECall::OpenFileAtLine: return TEXT("OpenFileAtLine");
+		case ECall::OpenSourceFiles: return TEXT("OpenSourceFiles");
+		case ECall::OpenSolution: return TEXT("OpenSolution");
+		case ECall::DoesSolutionExist: return TEXT("DoesSolutionExist");
+		case ECall::AddSourceFiles: return TEXT("AddSourceFiles");
+		default: return TEXT("Unknown");
+	}
+}
+
+static FAutoConsoleCommand RiderTraceStartCommand(
+	TEXT("Rider.Trace.Start"),
+	TEXT("Records the calls the editor makes into the Rider accessors until Rider.Trace.Stop. Args: [TracePath=<Project>/Saved/Rider/Calls.trace]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		FRiderCallTrace::Start(Args.Num() > 0 ? Args[0] : FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Rider"), TEXT("Calls.trace")));
+	}));
+
+static FAutoConsoleCommand RiderTraceStopCommand(
+	TEXT("Rider.Trace.Stop"),
+	TEXT("Writes the calls recorded since Rider.Trace.Start"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FRiderCallTrace::Stop();
+	}));
@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Atomic.h"
+
+/**
+ * Optional recording of the calls the editor makes into the registered accessors, with their timing and arguments,
+ * for replaying production workloads with Rider.Benchmark.Replay.
+ * Traces are kept in memory while recording and written on Stop: a string table followed by the calls, every path
+ * stored once and every number packed, so a day of editor use stays in the kilobytes.
+ */
+class FRiderCallTrace
+{
+public:
+	static const int32 FormatVersion = 1;
+
+	enum class ECall : uint8
+	{
+		OpenFileAtLine,
+		OpenSourceFiles,
+		OpenSolution,
+		DoesSolutionExist,
+		AddSourceFiles,
+		Num
+	};
+
+	struct FCall
+	{
+		/** Since the first recorded call */
+		double Seconds = 0.0;
+		ECall Call = ECall::OpenSolution;
+		TArray<FString> Paths;
+		TArray<FString> Modules;
+		int32 Line = 0;
+		int32 Column = 0;
+	};
+
+	/** Starts recording if CallTracePath is set */
+	static void Initialize();
+
+	/** Writes a running trace */
+	static void Shutdown();
+
+	/** Starts a trace that Stop writes to Path, a running trace is written to its own path first */
+	static void Start(const FString& Path);
+
+	/** Writes and ends the running trace, false if none was running or it couldn't be written */
+	static bool Stop();
+
+	static bool IsRecording() { return bRecording.Load(EMemoryOrder::Relaxed); }
+
+	/** Thread safe, costs a single load while not recording */
+	static void Record(ECall Call, TArrayView<const FString> Paths = {}, TArrayView<const FString> Modules = {}, int32 Line = 0, int32 Column = 0)
+	{
+		if (IsRecording())
+		{
+			Append(Call, Paths, Modules, Line, Column);
+		}
+	}
+
+	static TOptional<TArray<FCall>> Load(const FString& Path);
+
+	static const TCHAR* GetCallName(ECall Call);
+
+private:
+	static void Append(ECall Call, TArrayView<const FString> Paths, TArrayView<const FString> Modules, int32 Line, int32 Column);
+
+	static TAtomic<bool> bRecording;
+};
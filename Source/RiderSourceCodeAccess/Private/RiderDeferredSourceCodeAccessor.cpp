@@ -0,0 +1,210 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderDeferredSourceCodeAccessor.h"
+
+#include "RiderCallTrace.h"
+#include "RiderPathLocator/RiderPathLocator.h"
+#include "RiderRunningInstances.h"
+
+#include "Misc/ScopeLock.h"
+
+#define LOCTEXT_NAMESPACE "RiderSourceCodeAccessor"
+
+FRiderDeferredSourceCodeAccessor::FRiderDeferredSourceCodeAccessor(FName InName, FRiderSourceCodeAccessor::EProjectModel InModel, FRiderSourceCodeAccessor::EAccessType InType,
+	TFunction<TArray<FInstallInfo>()> InInstallsResolver)
+	: Name(InName)
+	, Model(InModel)
+	, Type(InType)
+	, InstallsResolver(MoveTemp(InInstallsResolver))
+{
+}
+
+void FRiderDeferredSourceCodeAccessor::InvalidateInstalls()
+{
+	FScopeLock Lock(&AccessorCriticalSection);
+	InstallsGeneration++;
+}
+
+void FRiderDeferredSourceCodeAccessor::ResolveInstalls() const
+{
+	uint32 Generation = 0;
+	{
+		FScopeLock Lock(&AccessorCriticalSection);
+		if (ResolvedGeneration == InstallsGeneration) return;
+		Generation = InstallsGeneration;
+	}
+
+	// Concurrent first calls may both resolve, the module serializes discovery so only one of them runs it
+	TArray<FInstallInfo> ResolvedInstalls = InstallsResolver();
+
+	FScopeLock Lock(&AccessorCriticalSection);
+	if (ResolvedGeneration != Generation)
+	{
+		Installs = MoveTemp(ResolvedInstalls);
+		ResolvedGeneration = Generation;
+	}
+}
+
+FRiderSourceCodeAccessor* FRiderDeferredSourceCodeAccessor::GetAccessorFor(const FInstallInfo& InstallInfo) const
+{
+	TUniquePtr<FRiderSourceCodeAccessor>& RiderAccessor = Accessors.FindOrAdd(InstallInfo.GetPath());
+	if (!RiderAccessor.IsValid())
+	{
+		RiderAccessor = MakeUnique<FRiderSourceCodeAccessor>();
+		RiderAccessor->Init(InstallInfo, Model, Type);
+	}
+	return RiderAccessor.Get();
+}
+
+FRiderSourceCodeAccessor* FRiderDeferredSourceCodeAccessor::GetAccessor() const
+{
+	ResolveInstalls();
+	FScopeLock Lock(&AccessorCriticalSection);
+	return Installs.Num() > 0 ? GetAccessorFor(Installs.Last()) : nullptr;
+}
+
+FRiderSourceCodeAccessor* FRiderDeferredSourceCodeAccessor::GetAccessorForOpen() const
+{
+	ResolveInstalls();
+	TArray<FInstallInfo> Candidates;
+	{
+		FScopeLock Lock(&AccessorCriticalSection);
+		Candidates = Installs;
+	}
+	if (Candidates.Num() == 0) return nullptr;
+
+	// Scanning processes happens outside the lock, calls for other requests shouldn't wait for it
+	const TOptional<FInstallInfo> RunningInstall = Candidates.Num() > 1 ? RiderRunningInstances::FindNewestRunning(Candidates) : TOptional<FInstallInfo>();
+
+	FScopeLock Lock(&AccessorCriticalSection);
+	return GetAccessorFor(RunningInstall.IsSet() ? RunningInstall.GetValue() : Candidates.Last());
+}
+
+FRiderSourceCodeAccessor* FRiderDeferredSourceCodeAccessor::GetExistingAccessor() const
+{
+	FScopeLock Lock(&AccessorCriticalSection);
+	for (int32 Index = Installs.Num() - 1; Index >= 0; Index--)
+	{
+		if (const TUniquePtr<FRiderSourceCodeAccessor>* RiderAccessor = Accessors.Find(Installs[Index].GetPath()))
+		{
+			return RiderAccessor->Get();
+		}
+	}
+
+	// One created for an install a previous resolve still listed
+	for (const TPair<FString, TUniquePtr<FRiderSourceCodeAccessor>>& Pair : Accessors)
+	{
+		return Pair.Value.Get();
+	}
+	return nullptr;
+}
+
+bool FRiderDeferredSourceCodeAccessor::Prelaunch()
+{
+	FRiderSourceCodeAccessor* RiderAccessor = GetAccessor();
+	return RiderAccessor != nullptr && RiderAccessor->Prelaunch();
+}
+
+bool FRiderDeferredSourceCodeAccessor::OpenSymbol(const FString& SymbolName)
+{
+	FRiderSourceCodeAccessor* RiderAccessor = GetAccessorForOpen();
+	return RiderAccessor != nullptr && RiderAccessor->OpenSymbol(SymbolName);
+}
+
+void FRiderDeferredSourceCodeAccessor::RefreshAvailability()
+{
+	if (FRiderSourceCodeAccessor* RiderAccessor = GetAccessor())
+	{
+		RiderAccessor->RefreshAvailability();
+	}
+}
+
+bool FRiderDeferredSourceCodeAccessor::CanAccessSourceCode() const
+{
+	const FRiderSourceCodeAccessor* RiderAccessor = GetAccessor();
+	return RiderAccessor != nullptr && RiderAccessor->CanAccessSourceCode();
+}
+
+bool FRiderDeferredSourceCodeAccessor::DoesSolutionExist() const
+{
+	FRiderCallTrace::Record(FRiderCallTrace::ECall::DoesSolutionExist);
+	const FRiderSourceCodeAccessor* RiderAccessor = GetAccessor();
+	return RiderAccessor != nullptr && RiderAccessor->DoesSolutionExist();
+}
+
+FName FRiderDeferredSourceCodeAccessor::GetFName() const
+{
+	return Name;
+}
+
+FText FRiderDeferredSourceCodeAccessor::GetNameText() const
+{
+	return FText::FromName(Name);
+}
+
+FText FRiderDeferredSourceCodeAccessor::GetDescriptionText() const
+{
+	return LOCTEXT("RiderDisplayDesc", "Open source code files in Rider");
+}
+
+bool FRiderDeferredSourceCodeAccessor::OpenSolution()
+{
+	FRiderCallTrace::Record(FRiderCallTrace::ECall::OpenSolution);
+	FRiderSourceCodeAccessor* RiderAccessor = GetAccessorForOpen();
+	return RiderAccessor != nullptr && RiderAccessor->OpenSolution();
+}
+
+bool FRiderDeferredSourceCodeAccessor::OpenSolutionAtPath(const FString& InSolutionPath)
+{
+	FRiderSourceCodeAccessor* RiderAccessor = GetAccessorForOpen();
+	return RiderAccessor != nullptr && RiderAccessor->OpenSolutionAtPath(InSolutionPath);
+}
+
+bool FRiderDeferredSourceCodeAccessor::OpenFileAtLine(const FString& FullPath, int32 LineNumber, int32 ColumnNumber)
+{
+	FRiderCallTrace::Record(FRiderCallTrace::ECall::OpenFileAtLine, MakeArrayView(&FullPath, 1), {}, LineNumber, ColumnNumber);
+	FRiderSourceCodeAccessor* RiderAccessor = GetAccessorForOpen();
+	return RiderAccessor != nullptr && RiderAccessor->OpenFileAtLine(FullPath, LineNumber, ColumnNumber);
+}
+
+bool FRiderDeferredSourceCodeAccessor::OpenSourceFiles(const TArray<FString>& AbsoluteSourcePaths)
+{
+	FRiderCallTrace::Record(FRiderCallTrace::ECall::OpenSourceFiles, AbsoluteSourcePaths);
+	FRiderSourceCodeAccessor* RiderAccessor = GetAccessorForOpen();
+	return RiderAccessor != nullptr && RiderAccessor->OpenSourceFiles(AbsoluteSourcePaths);
+}
+
+bool FRiderDeferredSourceCodeAccessor::AddSourceFiles(const TArray<FString>& AbsoluteSourcePaths, const TArray<FString>& AvailableModules)
+{
+	FRiderCallTrace::Record(FRiderCallTrace::ECall::AddSourceFiles, AbsoluteSourcePaths, AvailableModules);
+	if (FRiderSourceCodeAccessor* RiderAccessor = GetExistingAccessor())
+	{
+		return RiderAccessor->AddSourceFiles(AbsoluteSourcePaths, AvailableModules);
+	}
+
+	// Same answer as the real accessor, without forcing discovery for a call that never launches the IDE
+	return Model == FRiderSourceCodeAccessor::EProjectModel::Uproject;
+}
+
+bool FRiderDeferredSourceCodeAccessor::SaveAllOpenDocuments() const
+{
+	return false;
+}
+
+void FRiderDeferredSourceCodeAccessor::Tick(const float DeltaTime)
+{
+	TArray<FRiderSourceCodeAccessor*> ExistingAccessors;
+	{
+		FScopeLock Lock(&AccessorCriticalSection);
+		for (const TPair<FString, TUniquePtr<FRiderSourceCodeAccessor>>& Pair : Accessors)
+		{
+			ExistingAccessors.Add(Pair.Value.Get());
+		}
+	}
+	for (FRiderSourceCodeAccessor* RiderAccessor : ExistingAccessors)
+	{
+		RiderAccessor->Tick(DeltaTime);
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
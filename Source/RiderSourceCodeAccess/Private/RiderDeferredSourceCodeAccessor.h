@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "RiderSourceCodeAccessor.h"
+
+/**
+ * Stand-in that creates the real accessor on the first call that needs an install.
+ * The aggregate resolvers run Rider discovery, so processes that never open an IDE (automation, unattended and
+ * headless editors) never pay for it. Per-version accessors are only initialized once listed or selected.
+ * Aggregates choose between several installs: open requests go to the newest one that is already running, so an open
+ * IDE is reused instead of starting a second one, everything else goes to the newest install.
+ */
+class FRiderDeferredSourceCodeAccessor : public ISourceCodeAccessor
+{
+public:
+	/** InstallsResolver returns the installs to choose from sorted oldest first, a single one for per-version accessors */
+	FRiderDeferredSourceCodeAccessor(FName InName, FRiderSourceCodeAccessor::EProjectModel InModel, FRiderSourceCodeAccessor::EAccessType InType,
+		TFunction<TArray<FInstallInfo>()> InInstallsResolver);
+
+	/** Resolves the installs again on next use, for when the list the resolver reads from changed */
+	void InvalidateInstalls();
+
+	/** Starts the IDE in the background, see FRiderSourceCodeAccessor::Prelaunch */
+	bool Prelaunch();
+
+	FRiderSourceCodeAccessor::EProjectModel GetModel() const { return Model; }
+
+	/** See FRiderSourceCodeAccessor::OpenSymbol */
+	bool OpenSymbol(const FString& SymbolName);
+
+	/** ISourceCodeAccessor implementation */
+	virtual void RefreshAvailability() override;
+	virtual bool CanAccessSourceCode() const override;
+	virtual bool DoesSolutionExist() const override;
+	virtual FName GetFName() const override;
+	virtual FText GetNameText() const override;
+	virtual FText GetDescriptionText() const override;
+	virtual bool OpenSolution() override;
+	virtual bool OpenSolutionAtPath(const FString& InSolutionPath) override;
+	virtual bool OpenFileAtLine(const FString& FullPath, int32 LineNumber, int32 ColumnNumber = 0) override;
+	virtual bool OpenSourceFiles(const TArray<FString>& AbsoluteSourcePaths) override;
+	virtual bool AddSourceFiles(const TArray<FString>& AbsoluteSourcePaths, const TArray<FString>& AvailableModules) override;
+	virtual bool SaveAllOpenDocuments() const override;
+	virtual void Tick(const float DeltaTime) override;
+private:
+	/** Returns the real accessor for the newest install, running discovery on first use. Null if no suitable Rider is installed */
+	FRiderSourceCodeAccessor* GetAccessor() const;
+
+	/** Like GetAccessor, but prefers the newest install that is already running */
+	FRiderSourceCodeAccessor* GetAccessorForOpen() const;
+
+	/** Returns an already created accessor without running discovery, preferring the newest install */
+	FRiderSourceCodeAccessor* GetExistingAccessor() const;
+
+	/** Runs the resolver without holding AccessorCriticalSection, discovery can take seconds */
+	void ResolveInstalls() const;
+
+	/** Needs AccessorCriticalSection to be held */
+	FRiderSourceCodeAccessor* GetAccessorFor(const FInstallInfo& InstallInfo) const;
+
+	FName Name;
+	FRiderSourceCodeAccessor::EProjectModel Model;
+	FRiderSourceCodeAccessor::EAccessType Type;
+
+	mutable FCriticalSection AccessorCriticalSection;
+	TFunction<TArray<FInstallInfo>()> InstallsResolver;
+	mutable TArray<FInstallInfo> Installs;
+
+	/** Installs are resolved again while ResolvedGeneration lags InstallsGeneration */
+	uint32 InstallsGeneration = 1;
+	mutable uint32 ResolvedGeneration = 0;
+
+	/** Real accessors by install path, created on first use */
+	mutable TMap<FString, TUniquePtr<FRiderSourceCodeAccessor>> Accessors;
+};
@@ -0,0 +1,132 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderInstanceRouter.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRiderInstanceRouter, Log, All);
+
+static FString RoutesPathOverride;
+
+FString FRiderInstanceRouter::GetRoutesPath()
+{
+	if (!RoutesPathOverride.IsEmpty()) return RoutesPathOverride;
+	return FPaths::Combine(FPlatformProcess::UserTempDir(), TEXT("RiderSourceCodeAccess"), TEXT("Routes.json"));
+}
+
+void FRiderInstanceRouter::SetRoutesPathOverride(const FString& Path)
+{
+	RoutesPathOverride = Path;
+}
+
+FString FRiderInstanceRouter::GetKey(const FString& SolutionPath)
+{
+	FString Key = FPaths::ConvertRelativePathToFull(SolutionPath);
+	FPaths::NormalizeFilename(Key);
+	return Key;
+}
+
+bool FRiderInstanceRouter::IsRunning(const FRoute& Route)
+{
+	// Process 0 means the calling process on Linux and Mac, such a route would never expire
+	return Route.ProcessId != 0 && FPlatformProcess::IsApplicationRunning(Route.ProcessId);
+}
+
+TOptional<FRiderInstanceRouter::FRoute> FRiderInstanceRouter::Find(const FString& SolutionPath)
+{
+	FSystemWideCriticalSection Lock(TEXT("RiderSourceCodeAccessRoutes"), FTimespan::FromSeconds(1));
+	if (!Lock.IsValid())
+	{
+		UE_LOG(LogRiderInstanceRouter, Verbose, TEXT("Couldn't acquire the routes lock, opening without a route"));
+		return {};
+	}
+
+	const TMap<FString, FRoute> Routes = Load();
+	const FRoute* Route = Routes.Find(GetKey(SolutionPath));
+	if (Route == nullptr || !IsRunning(*Route)) return {};
+	return *Route;
+}
+
+void FRiderInstanceRouter::Record(const FString& SolutionPath, const FRoute& Route)
+{
+	FSystemWideCriticalSection Lock(TEXT("RiderSourceCodeAccessRoutes"), FTimespan::FromSeconds(1));
+	if (!Lock.IsValid())
+	{
+		// Writing without the lock would drop routes other editors are writing at the same time
+		UE_LOG(LogRiderInstanceRouter, Verbose, TEXT("Couldn't acquire the routes lock, not recording the route for %s"), *SolutionPath);
+		return;
+	}
+
+	TMap<FString, FRoute> Routes = Load();
+	Routes.Add(GetKey(SolutionPath), Route);
+	for (auto It = Routes.CreateIterator(); It; ++It)
+	{
+		if (!IsRunning(It.Value()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+	Save(Routes);
+}
+
+TMap<FString, FRiderInstanceRouter::FRoute> FRiderInstanceRouter::Load()
+{
+	TMap<FString, FRoute> Routes;
+	FString Json;
+	if (!FFileHelper::LoadFileToString(Json, *GetRoutesPath())) return Routes;
+
+	TSharedPtr<FJsonObject> JsonObject;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid()) return Routes;
+
+	const TArray<TSharedPtr<FJsonValue>>* RouteValues;
+	if (!JsonObject->TryGetArrayField(TEXT("routes"), RouteValues)) return Routes;
+
+	for (const TSharedPtr<FJsonValue>& RouteValue : *RouteValues)
+	{
+		const TSharedPtr<FJsonObject>* RouteObject;
+		if (!RouteValue->TryGetObject(RouteObject)) continue;
+
+		FString SolutionPath;
+		FRoute Route;
+		if (!(*RouteObject)->TryGetStringField(TEXT("solution"), SolutionPath)) continue;
+		if (!(*RouteObject)->TryGetStringField(TEXT("executable"), Route.ExecutablePath)) continue;
+		(*RouteObject)->TryGetStringField(TEXT("fallbackExecutable"), Route.FallbackExecutablePath);
+		(*RouteObject)->TryGetNumberField(TEXT("pid"), Route.ProcessId);
+		Routes.Add(SolutionPath, Route);
+	}
+	return Routes;
+}
+
+void FRiderInstanceRouter::Save(const TMap<FString, FRoute>& Routes)
+{
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	Writer->WriteObjectStart();
+	Writer->WriteArrayStart(TEXT("routes"));
+	for (const TPair<FString, FRoute>& Route : Routes)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("solution"), Route.Key);
+		Writer->WriteValue(TEXT("executable"), Route.Value.ExecutablePath);
+		Writer->WriteValue(TEXT("fallbackExecutable"), Route.Value.FallbackExecutablePath);
+		Writer->WriteValue(TEXT("pid"), static_cast<int64>(Route.Value.ProcessId));
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	const FString RoutesPath = GetRoutesPath();
+	const FString TempPath = RoutesPath + TEXT(".tmp");
+	if (FFileHelper::SaveStringToFile(Json, *TempPath))
+	{
+		IFileManager::Get().Move(*RoutesPath, *TempPath);
+	}
+}
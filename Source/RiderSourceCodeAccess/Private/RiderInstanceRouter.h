@@ -0,0 +1,37 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Remembers which Rider install each solution was opened with, shared by all editors of the user.
+ * Requests for a solution go to the instance that already has it, so editors on different projects never make an
+ * unrelated instance reload. Routes whose process has exited are dropped.
+ */
+class FRiderInstanceRouter
+{
+public:
+	struct FRoute
+	{
+		FString ExecutablePath;
+		FString FallbackExecutablePath;
+		uint32 ProcessId = 0;
+	};
+
+	/** Route for the solution if the instance it was opened in is still running */
+	static TOptional<FRoute> Find(const FString& SolutionPath);
+
+	/** Route.ProcessId must be the running instance, routes without a process are ignored */
+	static void Record(const FString& SolutionPath, const FRoute& Route);
+
+	/** Routes file in the user's temp directory, tests point this somewhere else */
+	static FString GetRoutesPath();
+	static void SetRoutesPathOverride(const FString& Path);
+
+private:
+	static TMap<FString, FRoute> Load();
+	static void Save(const TMap<FString, FRoute>& Routes);
+	static FString GetKey(const FString& SolutionPath);
+	static bool IsRunning(const FRoute& Route);
+};
@@ -0,0 +1,100 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderInstanceRouter.h"
+#include "RiderSourceCodeAccessor.h"
+
+#include "RiderPathLocator/RiderPathLocator.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRiderRoutingCheck, Log, All);
+
+/**
+ * Checks solution routing against two stand-in IDE instances.
+ * Usage: Rider.Check.Routing (Linux and Mac only)
+ * Each stand-in records its arguments and stays alive for a while like a running IDE. Two accessors open one solution
+ * each, then the second accessor opens the first solution again, which has to reach the first stand-in.
+ */
+class FRiderInstanceRouterCheck
+{
+public:
+	static bool Run()
+	{
+#if PLATFORM_WINDOWS
+		UE_LOG(LogRiderRoutingCheck, Error, TEXT("Stand-in instances are shell scripts, run this on Linux or Mac"));
+		return false;
+#else
+		const FString Root = FPaths::Combine(FPlatformProcess::UserTempDir(), TEXT("RiderRoutingCheck"), FGuid::NewGuid().ToString());
+		FRiderInstanceRouter::SetRoutesPathOverride(FPaths::Combine(Root, TEXT("Routes.json")));
+
+		const FString SolutionA = FPaths::Combine(Root, TEXT("A.sln"));
+		const FString SolutionB = FPaths::Combine(Root, TEXT("B.sln"));
+		FFileHelper::SaveStringToFile(TEXT(""), *SolutionA);
+		FFileHelper::SaveStringToFile(TEXT(""), *SolutionB);
+
+		const FString LogA = FPaths::Combine(Root, TEXT("A.log"));
+		const FString LogB = FPaths::Combine(Root, TEXT("B.log"));
+		FRiderSourceCodeAccessor AccessorA;
+		FRiderSourceCodeAccessor AccessorB;
+		AccessorA.Init(FInstallInfo(GenerateStandIn(Root, TEXT("A"), LogA), FInstallInfo::EInstallType::Custom), FRiderSourceCodeAccessor::EProjectModel::Sln);
+		AccessorB.Init(FInstallInfo(GenerateStandIn(Root, TEXT("B"), LogB), FInstallInfo::EInstallType::Custom), FRiderSourceCodeAccessor::EProjectModel::Sln);
+
+		AccessorA.OpenSolutionAtPath(SolutionA);
+		AccessorB.OpenSolutionAtPath(SolutionB);
+		AccessorB.OpenSolutionAtPath(SolutionA);
+
+		const int32 NumA = WaitForLines(LogA, 2);
+		const int32 NumB = WaitForLines(LogB, 1);
+		const bool bPassed = NumA == 2 && NumB == 1;
+		UE_LOG(LogRiderRoutingCheck, Display, TEXT("Stand-in A got %d of 2 requests, stand-in B got %d of 1: %s"), NumA, NumB, bPassed ? TEXT("passed") : TEXT("FAILED"));
+
+		FRiderInstanceRouter::SetRoutesPathOverride(FString());
+		IFileManager::Get().DeleteDirectory(*Root, false, true);
+		return bPassed;
+#endif
+	}
+
+private:
+	static FString GenerateStandIn(const FString& Root, const TCHAR* Name, const FString& LogPath)
+	{
+		const FString StandInPath = FPaths::Combine(Root, FString(Name) + TEXT(".sh"));
+		const FString Script = FString::Printf(TEXT("#!/bin/sh\necho \"$*\" >> \"%s\"\nsleep 10\n"), *LogPath);
+		FFileHelper::SaveStringToFile(Script, *StandInPath);
+
+		int32 ReturnCode = 0;
+		FPlatformProcess::ExecProcess(TEXT("/bin/chmod"), *FString::Printf(TEXT("+x \"%s\""), *StandInPath), &ReturnCode, nullptr, nullptr);
+		return StandInPath;
+	}
+
+	static int32 WaitForLines(const FString& LogPath, int32 ExpectedLines)
+	{
+		TArray<FString> Lines;
+		const double Deadline = FPlatformTime::Seconds() + 5.0;
+		while (FPlatformTime::Seconds() < Deadline)
+		{
+			Lines.Reset();
+			FFileHelper::LoadFileToStringArray(Lines, *LogPath);
+			if (Lines.Num() >= ExpectedLines) break;
+			FPlatformProcess::Sleep(0.05f);
+		}
+		// Give stray requests a moment to land so misrouting shows up as an extra line
+		FPlatformProcess::Sleep(0.2f);
+		Lines.Reset();
+		FFileHelper::LoadFileToStringArray(Lines, *LogPath);
+		return Lines.Num();
+	}
+};
+
+static FAutoConsoleCommand RiderRoutingCheckCommand(
+	TEXT("Rider.Check.Routing"),
+	TEXT("Opens solutions through two stand-in IDE instances and checks that each request reaches the instance that has its solution"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FRiderInstanceRouterCheck::Run();
+	}));
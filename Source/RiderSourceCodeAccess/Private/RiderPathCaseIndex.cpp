@@ -0,0 +1,123 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderPathCaseIndex.h"
+
+#include "RiderSourceTree.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+static TUniquePtr<FRiderPathCaseIndex> PathCaseIndex;
+
+void FRiderPathCaseIndex::Initialize()
+{
+	if (PathCaseIndex.IsValid()) return;
+
+	PathCaseIndex = MakeUnique<FRiderPathCaseIndex>();
+	if (FRiderSourceTreeWatcher* Watcher = FRiderSourceTreeWatcher::Get())
+	{
+		PathCaseIndex->FilesChangedHandle = Watcher->OnFilesChanged().AddRaw(PathCaseIndex.Get(), &FRiderPathCaseIndex::HandleFilesChanged);
+	}
+}
+
+void FRiderPathCaseIndex::Shutdown()
+{
+	PathCaseIndex.Reset();
+}
+
+FRiderPathCaseIndex* FRiderPathCaseIndex::Get()
+{
+	return PathCaseIndex.Get();
+}
+
+FRiderPathCaseIndex::~FRiderPathCaseIndex()
+{
+	if (FRiderSourceTreeWatcher* Watcher = FRiderSourceTreeWatcher::Get())
+	{
+		Watcher->OnFilesChanged().Remove(FilesChangedHandle);
+	}
+}
+
+TOptional<FString> FRiderPathCaseIndex::Resolve(const FString& Path)
+{
+	if (FPaths::FileExists(Path)) return Path;
+
+	FString NormalizedPath = FPaths::ConvertRelativePathToFull(Path);
+	FPaths::NormalizeFilename(NormalizedPath);
+
+	TArray<FString> Components;
+	NormalizedPath.ParseIntoArray(Components, TEXT("/"));
+	if (Components.Num() == 0) return {};
+
+	// Drive letters and UNC hosts are matched as given, file systems that have them don't care about case
+	FString Current = NormalizedPath.StartsWith(TEXT("//")) ? TEXT("//") : NormalizedPath.StartsWith(TEXT("/")) ? TEXT("/") : TEXT("");
+	int32 FirstComponent = 0;
+	if (Current.IsEmpty() || Current == TEXT("//"))
+	{
+		Current += Components[0];
+		FirstComponent = 1;
+	}
+
+	FScopeLock Lock(&CriticalSection);
+	for (int32 Index = FirstComponent; Index < Components.Num(); Index++)
+	{
+		const TOptional<FString> Entry = FindEntry(Current, Components[Index]);
+		if (!Entry.IsSet()) return {};
+
+		Current = FPaths::Combine(Current, Entry.GetValue());
+	}
+
+	if (!FPaths::FileExists(Current)) return {};
+	return Current;
+}
+
+TOptional<FString> FRiderPathCaseIndex::FindEntry(const FString& Directory, const FString& Name)
+{
+	TArray<const FString*, TInlineAllocator<2>> Candidates;
+	for (bool bForceRead : { false, true })
+	{
+		const FDirectoryListing& Listing = GetListing(Directory, bForceRead);
+		Candidates.Reset();
+		Listing.Entries.MultiFindPointer(Name.ToLower(), Candidates);
+		if (Candidates.Num() > 0 || FPlatformTime::Seconds() - Listing.ReadTime < MissRescanSeconds) break;
+	}
+	if (Candidates.Num() == 0) return {};
+
+	for (const FString* Candidate : Candidates)
+	{
+		if (Candidate->Equals(Name, ESearchCase::CaseSensitive)) return *Candidate;
+	}
+	return *Candidates[0];
+}
+
+const FRiderPathCaseIndex::FDirectoryListing& FRiderPathCaseIndex::GetListing(const FString& Directory, bool bForceRead)
+{
+	TSharedPtr<FDirectoryListing>& Listing = Listings.FindOrAdd(Directory);
+	if (Listing.IsValid() && !bForceRead) return *Listing;
+
+	Listing = MakeShared<FDirectoryListing>();
+	Listing->ReadTime = FPlatformTime::Seconds();
+	IFileManager::Get().IterateDirectory(*Directory, [&Listing](const TCHAR* EntryPath, bool bIsDirectory)
+	{
+		const FString EntryName = FPaths::GetCleanFilename(EntryPath);
+		Listing->Entries.Add(EntryName.ToLower(), EntryName);
+		return true;
+	});
+	return *Listing;
+}
+
+void FRiderPathCaseIndex::HandleFilesChanged(const TArray<FFileChangeData>& Changes)
+{
+	FScopeLock Lock(&CriticalSection);
+	for (const FFileChangeData& Change : Changes)
+	{
+		if (Change.Action == FFileChangeData::FCA_Modified) continue;
+
+		FString Path = Change.Filename;
+		FPaths::NormalizeFilename(Path);
+		Listings.Remove(FPaths::GetPath(Path));
+		Listings.Remove(Path);
+	}
+}
@@ -0,0 +1,52 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IDirectoryWatcher.h"
+
+/**
+ * Maps paths with the wrong casing (e.g. from Windows builders) to the casing used on disk.
+ * Directory listings are read lazily, one per directory, and dropped when the source tree watcher reports changes in them.
+ */
+class FRiderPathCaseIndex
+{
+public:
+	static void Initialize();
+	static void Shutdown();
+
+	/** Null until Initialize has been called */
+	static FRiderPathCaseIndex* Get();
+
+	~FRiderPathCaseIndex();
+
+	/** Existing file matching Path case-insensitively, unset if there is none */
+	TOptional<FString> Resolve(const FString& Path);
+
+private:
+	struct FDirectoryListing
+	{
+		/** Lowercase entry name -> names on disk, more than one on case-sensitive file systems only */
+		TMultiMap<FString, FString> Entries;
+		double ReadTime = 0.0;
+	};
+
+	/** Case-sensitive keys, two directories differing only in case are different directories here */
+	struct FDirectoryKeyFuncs : BaseKeyFuncs<TPair<FString, TSharedPtr<FDirectoryListing>>, FString>
+	{
+		static const FString& GetSetKey(const TPair<FString, TSharedPtr<FDirectoryListing>>& Element) { return Element.Key; }
+		static bool Matches(const FString& A, const FString& B) { return A.Equals(B, ESearchCase::CaseSensitive); }
+		static uint32 GetKeyHash(const FString& Key) { return FCrc::StrCrc32(*Key); }
+	};
+
+	/** A miss in a listing older than this re-reads the directory once, for directories the watcher doesn't cover */
+	static constexpr double MissRescanSeconds = 1.0;
+
+	const FDirectoryListing& GetListing(const FString& Directory, bool bForceRead);
+	TOptional<FString> FindEntry(const FString& Directory, const FString& Name);
+	void HandleFilesChanged(const TArray<FFileChangeData>& Changes);
+
+	FCriticalSection CriticalSection;
+	TMap<FString, TSharedPtr<FDirectoryListing>, FDefaultSetAllocator, FDirectoryKeyFuncs> Listings;
+	FDelegateHandle FilesChangedHandle;
+};
@@ -0,0 +1,301 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderPathLocator/RiderInstallCache.h"
+
+#include "RiderPathLocator/RiderPathLocator.h"
+
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Crc.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "Templates/Atomic.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRiderInstallCache, Log, All);
+
+namespace RiderInstallCache
+{
+	static const uint32 Magic = 0x52534341; // 'RSCA'
+	static const uint32 FormatVersion = 2;
+
+	static const TCHAR* LockName = TEXT("RiderSourceCodeAccessInstallCache");
+
+	/** A claim older than this is taken over even if its process is still alive, discovery never takes that long */
+	static const double MaxPendingSeconds = 300.0;
+
+	/** An empty result is only shared this long, a Rider installed right after it was written should be found soon */
+	static const double EmptyLifetimeSeconds = 30.0;
+
+	/** Set while the .pending file is this process' claim, only the claiming process may remove it */
+	static TAtomic<bool> bClaimed { false };
+
+	/** Custom locations differ between engines and plugin copies, so they are part of the cache's identity */
+	static uint32 GetLocationsHash()
+	{
+		FString LocationsFile = FRiderPathLocator::GetResourceLocationsFile();
+		FPaths::NormalizeFilename(LocationsFile);
+		FString Locations;
+		FFileHelper::LoadFileToString(Locations, *LocationsFile, FFileHelper::EHashOptions::None, FILEREAD_Silent);
+		return FCrc::StrCrc32(*(LocationsFile + TEXT("\n") + Locations));
+	}
+
+	/**
+	 * Flat, relocatable layout: header, fixed-size records, then the path characters.
+	 * Records reference paths by offset into the string block, so the file is used in place without parsing.
+	 */
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 FormatVersion;
+		uint32 CharSize;
+		uint32 NumRecords;
+		int64 WriteTimeTicks;
+		uint64 StringsOffset;
+		uint64 StringsNum;
+	};
+
+	struct FRecord
+	{
+		uint64 PathOffset;
+		uint64 NativeLauncherPathOffset;
+		uint32 PathNum;
+		uint32 NativeLauncherPathNum;
+		int32 VersionComponents[FVersion::MAX_COMPONENTS];
+		int32 NumVersionComponents;
+		uint8 SupportUprojectState;
+		uint8 InstallType;
+		uint8 Padding[2];
+	};
+}
+
+FString FRiderInstallCache::GetCachePath()
+{
+	return FPaths::Combine(FPlatformProcess::UserTempDir(), TEXT("RiderSourceCodeAccess"), FString::Printf(TEXT("Installs-%08x.bin"), RiderInstallCache::GetLocationsHash()));
+}
+
+FString FRiderInstallCache::GetPendingPath()
+{
+	return GetCachePath() + TEXT(".pending");
+}
+
+void FRiderInstallCache::ClaimDiscovery()
+{
+	const FString Claim = FString::Printf(TEXT("%u %lld"), FPlatformProcess::GetCurrentProcessId(), FDateTime::UtcNow().GetTicks());
+	RiderInstallCache::bClaimed = FFileHelper::SaveStringToFile(Claim, *GetPendingPath());
+}
+
+bool FRiderInstallCache::ReadClaim(uint32& OutProcessId, FTimespan& OutAge)
+{
+	FString Claim;
+	if (!FFileHelper::LoadFileToString(Claim, *GetPendingPath(), FFileHelper::EHashOptions::None, FILEREAD_Silent)) return false;
+
+	FString ProcessIdString;
+	FString TicksString;
+	if (!Claim.Split(TEXT(" "), &ProcessIdString, &TicksString)) return false;
+
+	OutProcessId = FCString::Strtoui64(*ProcessIdString, nullptr, 10);
+	OutAge = FDateTime::UtcNow() - FDateTime(FCString::Atoi64(*TicksString));
+	return true;
+}
+
+bool FRiderInstallCache::IsDiscoveryPendingElsewhere()
+{
+	uint32 ProcessId = 0;
+	FTimespan Age;
+	if (!ReadClaim(ProcessId, Age)) return false;
+
+	// A claim left behind by a process that exited or hung is taken over
+	return ProcessId != 0 && ProcessId != FPlatformProcess::GetCurrentProcessId() && FPlatformProcess::IsApplicationRunning(ProcessId)
+		&& Age >= FTimespan::Zero() && Age.GetTotalSeconds() < RiderInstallCache::MaxPendingSeconds;
+}
+
+void FRiderInstallCache::ReleaseClaim()
+{
+	if (!RiderInstallCache::bClaimed.Exchange(false)) return;
+
+	// Another process may have taken over a claim that outlived MaxPendingSeconds, that one isn't ours to remove
+	uint32 ProcessId = 0;
+	FTimespan Age;
+	if (ReadClaim(ProcessId, Age) && ProcessId == FPlatformProcess::GetCurrentProcessId())
+	{
+		IFileManager::Get().Delete(*GetPendingPath(), false, false, true);
+	}
+}
+
+TOptional<TArray<FInstallInfo>> FRiderInstallCache::Load(int32 LifetimeSeconds)
+{
+	using namespace RiderInstallCache;
+
+	const FString CachePath = GetCachePath();
+	TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*CachePath));
+	if (!MappedFile.IsValid() || MappedFile->GetFileSize() < static_cast<int64>(sizeof(FHeader))) return {};
+
+	TUniquePtr<IMappedFileRegion> Region(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	if (!Region.IsValid()) return {};
+
+	return Deserialize(TArrayView<const uint8>(Region->GetMappedPtr(), Region->GetMappedSize()), LifetimeSeconds);
+}
+
+TOptional<TArray<FInstallInfo>> FRiderInstallCache::Deserialize(TArrayView<const uint8> Buffer, int32 LifetimeSeconds)
+{
+	using namespace RiderInstallCache;
+
+	const uint8* Data = Buffer.GetData();
+	const uint64 Size = Buffer.Num();
+	if (Size < sizeof(FHeader)) return {};
+
+	const FHeader& Header = *reinterpret_cast<const FHeader*>(Data);
+	if (Header.Magic != Magic || Header.FormatVersion != FormatVersion || Header.CharSize != sizeof(TCHAR)) return {};
+	if (sizeof(FHeader) + static_cast<uint64>(Header.NumRecords) * sizeof(FRecord) > Header.StringsOffset) return {};
+	if (Header.StringsOffset + Header.StringsNum * sizeof(TCHAR) > Size) return {};
+
+	const FTimespan Age = FDateTime::UtcNow() - FDateTime(Header.WriteTimeTicks);
+	const double MaxAgeSeconds = Header.NumRecords > 0 ? LifetimeSeconds : FMath::Min<double>(LifetimeSeconds, EmptyLifetimeSeconds);
+	if (Age < FTimespan::Zero() || Age.GetTotalSeconds() > MaxAgeSeconds) return {};
+
+	const FRecord* Records = reinterpret_cast<const FRecord*>(Data + sizeof(FHeader));
+	const TCHAR* Strings = reinterpret_cast<const TCHAR*>(Data + Header.StringsOffset);
+
+	TArray<FInstallInfo> InstallInfos;
+	InstallInfos.Reserve(Header.NumRecords);
+	for (uint32 Index = 0; Index < Header.NumRecords; Index++)
+	{
+		const FRecord& Record = Records[Index];
+		if (Record.PathOffset + Record.PathNum > Header.StringsNum) return {};
+		if (Record.NativeLauncherPathOffset + Record.NativeLauncherPathNum > Header.StringsNum) return {};
+		if (Record.NumVersionComponents < 0 || Record.NumVersionComponents > FVersion::MAX_COMPONENTS) return {};
+		if (Record.SupportUprojectState > static_cast<uint8>(FInstallInfo::ESupportUproject::Release)) return {};
+		if (Record.InstallType > static_cast<uint8>(FInstallInfo::EInstallType::Custom)) return {};
+
+		FInstallInfo& InstallInfo = InstallInfos.Emplace_GetRef(FString(Record.PathNum, Strings + Record.PathOffset), static_cast<FInstallInfo::EInstallType>(Record.InstallType));
+		InstallInfo.Version = FVersion::FromComponents(TArrayView<const int32>(Record.VersionComponents, Record.NumVersionComponents));
+		InstallInfo.SupportUprojectState = static_cast<FInstallInfo::ESupportUproject>(Record.SupportUprojectState);
+		InstallInfo.NativeLauncherPath = FString(Record.NativeLauncherPathNum, Strings + Record.NativeLauncherPathOffset);
+
+		// An uninstalled Rider invalidates the whole cache, so the next discovery also picks up whatever replaced it
+		if (!FPaths::FileExists(InstallInfo.GetPath()) && !FPaths::DirectoryExists(InstallInfo.GetPath())) return {};
+	}
+	return InstallInfos;
+}
+
+TArray<uint8> FRiderInstallCache::Serialize(const TArray<FInstallInfo>& InstallInfos)
+{
+	using namespace RiderInstallCache;
+
+	TArray<FRecord> Records;
+	TArray<TCHAR> Strings;
+	for (const FInstallInfo& InstallInfo : InstallInfos)
+	{
+		const TArrayView<const int32> VersionComponents = InstallInfo.Version.GetComponents();
+
+		FRecord& Record = Records.AddZeroed_GetRef();
+		Record.PathOffset = Strings.Num();
+		Record.PathNum = InstallInfo.GetPath().Len();
+		Record.NumVersionComponents = VersionComponents.Num();
+		FMemory::Memcpy(Record.VersionComponents, VersionComponents.GetData(), VersionComponents.Num() * sizeof(int32));
+		Record.SupportUprojectState = static_cast<uint8>(InstallInfo.SupportUprojectState);
+		Record.InstallType = static_cast<uint8>(InstallInfo.InstallType);
+		Strings.Append(*InstallInfo.GetPath(), InstallInfo.GetPath().Len());
+		Record.NativeLauncherPathOffset = Strings.Num();
+		Record.NativeLauncherPathNum = InstallInfo.NativeLauncherPath.Len();
+		Strings.Append(*InstallInfo.NativeLauncherPath, InstallInfo.NativeLauncherPath.Len());
+	}
+
+	FHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = Magic;
+	Header.FormatVersion = FormatVersion;
+	Header.CharSize = sizeof(TCHAR);
+	Header.NumRecords = Records.Num();
+	Header.WriteTimeTicks = FDateTime::UtcNow().GetTicks();
+	Header.StringsOffset = sizeof(FHeader) + Records.Num() * sizeof(FRecord);
+	Header.StringsNum = Strings.Num();
+
+	TArray<uint8> Buffer;
+	Buffer.Append(reinterpret_cast<const uint8*>(&Header), sizeof(FHeader));
+	Buffer.Append(reinterpret_cast<const uint8*>(Records.GetData()), Records.Num() * sizeof(FRecord));
+	Buffer.Append(reinterpret_cast<const uint8*>(Strings.GetData()), Strings.Num() * sizeof(TCHAR));
+	return Buffer;
+}
+
+bool FRiderInstallCache::Save(const TArray<FInstallInfo>& InstallInfos)
+{
+	const TArray<uint8> Buffer = Serialize(InstallInfos);
+
+	// Write aside and move into place, so a concurrent reader maps either the old or the new file, never a partial one
+	const FString CachePath = GetCachePath();
+	const FString TempPath = CachePath + TEXT(".") + FGuid::NewGuid().ToString();
+	if (!FFileHelper::SaveArrayToFile(Buffer, *TempPath)) return false;
+	if (!IFileManager::Get().Move(*CachePath, *TempPath, true, true))
+	{
+		IFileManager::Get().Delete(*TempPath);
+		return false;
+	}
+	return true;
+}
+
+bool FRiderInstallCache::Publish(const TArray<FInstallInfo>& InstallInfos)
+{
+	// Saving moves the file into place, so readers need no lock, waiting processes pick it up on their next poll
+	const bool bSaved = Save(InstallInfos);
+	if (!bSaved)
+	{
+		UE_LOG(LogRiderInstallCache, Verbose, TEXT("Couldn't write the install cache to %s"), *GetCachePath());
+	}
+	ReleaseClaim();
+	return bSaved;
+}
+
+TArray<FInstallInfo> FRiderInstallCache::LoadOrCollect(int32 LifetimeSeconds, double WaitSeconds, TFunctionRef<TArray<FInstallInfo>(bool& bOutComplete)> Collect)
+{
+	bool bComplete = true;
+	if (LifetimeSeconds <= 0) return Collect(bComplete);
+
+	TOptional<TArray<FInstallInfo>> CachedInstallInfos = Load(LifetimeSeconds);
+	if (CachedInstallInfos.IsSet()) return MoveTemp(CachedInstallInfos.GetValue());
+
+	// The lock only covers checking and claiming, discovery itself runs without it so a slow one never queues the others
+	bool bPendingElsewhere = false;
+	{
+		FSystemWideCriticalSection Lock(RiderInstallCache::LockName, FTimespan::FromSeconds(5));
+		if (Lock.IsValid())
+		{
+			CachedInstallInfos = Load(LifetimeSeconds);
+			if (CachedInstallInfos.IsSet()) return MoveTemp(CachedInstallInfos.GetValue());
+
+			bPendingElsewhere = IsDiscoveryPendingElsewhere();
+			if (!bPendingElsewhere)
+			{
+				ClaimDiscovery();
+			}
+		}
+		else
+		{
+			UE_LOG(LogRiderInstallCache, Verbose, TEXT("Couldn't acquire the install cache lock, running discovery without it"));
+		}
+	}
+
+	if (bPendingElsewhere)
+	{
+		const double Deadline = FPlatformTime::Seconds() + WaitSeconds;
+		while (FPlatformTime::Seconds() < Deadline)
+		{
+			FPlatformProcess::Sleep(0.05f);
+			CachedInstallInfos = Load(LifetimeSeconds);
+			if (CachedInstallInfos.IsSet()) return MoveTemp(CachedInstallInfos.GetValue());
+		}
+		UE_LOG(LogRiderInstallCache, Verbose, TEXT("Another process is still discovering after %.1f s, running discovery here as well"), WaitSeconds);
+	}
+
+	TArray<FInstallInfo> InstallInfos = Collect(bComplete);
+	if (bComplete)
+	{
+		Publish(InstallInfos);
+	}
+	return InstallInfos;
+}
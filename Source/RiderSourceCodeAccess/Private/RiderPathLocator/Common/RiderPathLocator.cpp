@@ -1,13 +1,20 @@
 ﻿// Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "RiderPathLocator/RiderPathLocator.h"
+#include "Async/Async.h"
 #include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
 #include "Interfaces/IPluginManager.h"
 #include "Internationalization/Regex.h"
 #include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
 #include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
+#include "Stats/Stats.h"
 
 FString ExtractPathFromSettingsJson(const FString& ToolboxPath)
 {
@@ -38,28 +45,77 @@ bool FRiderPathLocator::DirectoryExistsAndNonEmpty(const FString& Path)
 	return !Path.IsEmpty() && FPaths::DirectoryExists(Path);
 }
 
-TArray<FInstallInfo> FRiderPathLocator::GetInstallInfosFromToolbox(const FString& ToolboxPath, const FString& Pattern)
+TArray<FInstallInfo> FRiderPathLocator::GetInstallInfosFromToolbox(FDiscoveryContext& Context, const FString& ToolboxPath, const FString& Pattern)
 {
 	if(!DirectoryExistsAndNonEmpty(ToolboxPath)) return {};
+
+	// Toolbox 2 keeps a manifest of the tools it installed, reading it saves walking every install's directory tree
+	const TOptional<TArray<FInstallInfo>> StateInstallInfos = GetInstallInfosFromToolboxState(Context, ToolboxPath);
+	if(StateInstallInfos.IsSet()) return StateInstallInfos.GetValue();
 	
 	const FString InstallLocationPath = ExtractPathFromSettingsJson(ToolboxPath);
 	TArray<FInstallInfo> Result{};
 	if(!InstallLocationPath.IsEmpty())
 	{
 		// Toolbox V1 custom install location search path
-		Result = GetInstallInfos(FPaths::Combine(InstallLocationPath, TEXT("apps")), Pattern, FInstallInfo::EInstallType::Toolbox);
+		Result = GetInstallInfos(Context, FPaths::Combine(InstallLocationPath, TEXT("apps")), Pattern, FInstallInfo::EInstallType::Toolbox);
 		if(Result.Num() != 0) return Result;
 
 		// Toolbox V2 custom install location search path
-		return GetInstallInfos(InstallLocationPath, Pattern, FInstallInfo::EInstallType::Toolbox);		
+		return GetInstallInfos(Context, InstallLocationPath, Pattern, FInstallInfo::EInstallType::Toolbox);		
 	}
 
 	// Toolbox V1 default install location search path
-	Result = GetInstallInfos(FPaths::Combine(ToolboxPath, TEXT("apps")), Pattern, FInstallInfo::EInstallType::Toolbox);
+	Result = GetInstallInfos(Context, FPaths::Combine(ToolboxPath, TEXT("apps")), Pattern, FInstallInfo::EInstallType::Toolbox);
 	if(Result.Num() != 0) return Result;
 
 	const FString DefaultInstallLocation = GetDefaultIDEInstallLocationForToolboxV2();
-	return GetInstallInfos(DefaultInstallLocation, Pattern, FInstallInfo::EInstallType::Toolbox);
+	return GetInstallInfos(Context, DefaultInstallLocation, Pattern, FInstallInfo::EInstallType::Toolbox);
+}
+
+TOptional<TArray<FInstallInfo>> FRiderPathLocator::GetInstallInfosFromToolboxState(FDiscoveryContext& Context, const FString& ToolboxPath)
+{
+	FString JsonStr;
+	if(!FFileHelper::LoadFileToString(JsonStr, *FPaths::Combine(ToolboxPath, TEXT("state.json")))) return {};
+
+	const TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(JsonStr);
+	TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject());
+	if (!FJsonSerializer::Deserialize(JsonReader, JsonObject) || !JsonObject.IsValid()) return {};
+
+	const TArray< TSharedPtr<FJsonValue> >* Tools;
+	if(!JsonObject->TryGetArrayField(TEXT("tools"), Tools)) return {};
+
+	TArray<FInstallInfo> RiderInstallInfos;
+	for (const TSharedPtr<FJsonValue>& Tool : *Tools)
+	{
+		const TSharedPtr<FJsonObject> Item = Tool->AsObject();
+		if(!Item.IsValid()) continue;
+
+		FString ToolId, ProductCode;
+		Item->TryGetStringField(TEXT("toolId"), ToolId);
+		Item->TryGetStringField(TEXT("productCode"), ProductCode);
+		if(ToolId != TEXT("Rider") && ProductCode != TEXT("RD")) continue;
+
+		FString InstallLocation, LaunchCommand, BuildNumber;
+		if(!Item->TryGetStringField(TEXT("installLocation"), InstallLocation) || !Item->TryGetStringField(TEXT("launchCommand"), LaunchCommand)) return {};
+		Item->TryGetStringField(TEXT("buildNumber"), BuildNumber);
+
+		// Mac installs are probed by their bundle, the launch command points inside it
+		FString LauncherPath = FPaths::Combine(InstallLocation, LaunchCommand);
+		const int32 BundleEnd = LauncherPath.Find(TEXT(".app/"));
+		if(BundleEnd != INDEX_NONE)
+		{
+			LauncherPath.LeftInline(BundleEnd + 4);
+		}
+
+		// A launcher that is gone or reports another build means Toolbox changed the install after writing the manifest
+		TOptional<FInstallInfo> InstallInfo = Context.Probe(LauncherPath, FInstallInfo::EInstallType::Toolbox);
+		if(!InstallInfo.IsSet()) return {};
+		if(!BuildNumber.IsEmpty() && InstallInfo->Version != FVersion(BuildNumber)) return {};
+
+		RiderInstallInfos.Add(InstallInfo.GetValue());
+	}
+	return RiderInstallInfos;
 }
 
 FVersion FRiderPathLocator::GetLastBuildVersion(const FString& HistoryJsonPath)
@@ -102,7 +158,7 @@ FString FRiderPathLocator::GetHistoryJsonPath(const FString& RiderPath)
 	return {};
 }
 
-TArray<FInstallInfo> FRiderPathLocator::GetInstallInfos(const FString& ToolboxRiderRootPath, const FString& Pattern, FInstallInfo::EInstallType InstallType)
+TArray<FInstallInfo> FRiderPathLocator::GetInstallInfos(FDiscoveryContext& Context, const FString& ToolboxRiderRootPath, const FString& Pattern, FInstallInfo::EInstallType InstallType)
 {
 	if(!DirectoryExistsAndNonEmpty(ToolboxRiderRootPath)) return {};
 	
@@ -111,7 +167,7 @@ TArray<FInstallInfo> FRiderPathLocator::GetInstallInfos(const FString& ToolboxRi
 	IFileManager::Get().FindFilesRecursive(RiderPaths, *ToolboxRiderRootPath, *Pattern, true, true);
 	for(const FString& RiderPath: RiderPaths)
 	{
-		TOptional<FInstallInfo> InstallInfo = GetInstallInfoFromRiderPath(RiderPath, InstallType);
+		TOptional<FInstallInfo> InstallInfo = Context.Probe(RiderPath, InstallType);
 		if(!InstallInfo.IsSet()) continue;
 		
 		FString HistoryJsonPath = GetHistoryJsonPath(RiderPath);
@@ -164,12 +220,24 @@ void FRiderPathLocator::ParseProductInfoJson(FInstallInfo& Info, const FString&
 	}
 }
 
-TArray<FInstallInfo> FRiderPathLocator::GetInstallInfosFromResourceFile()
+FString FRiderPathLocator::GetResourceLocationsFile()
 {
 	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("RiderSourceCodeAccess"));
 	if(!Plugin.IsValid()) return {};
-	
-	const FString RiderLocationsFile = FPaths::Combine(Plugin->GetBaseDir(), TEXT("Resources"), TEXT("RiderLocations.txt"));
+
+	return FPaths::Combine(Plugin->GetBaseDir(), TEXT("Resources"), TEXT("RiderLocations.txt"));
+}
+
+TArray<FInstallInfo> FRiderPathLocator::GetInstallInfosFromResourceFile(FDiscoveryContext& Context)
+{
+	const FString RiderLocationsFile = GetResourceLocationsFile();
+	if(RiderLocationsFile.IsEmpty()) return {};
+
+	return GetInstallInfosFromLocationsFile(Context, RiderLocationsFile);
+}
+
+TArray<FInstallInfo> FRiderPathLocator::GetInstallInfosFromLocationsFile(FDiscoveryContext& Context, const FString& RiderLocationsFile)
+{
 	TArray<FString> RiderLocations;
 	if(FFileHelper::LoadFileToStringArray(RiderLocations, *RiderLocationsFile) == false) return {};
 
@@ -179,7 +247,7 @@ TArray<FInstallInfo> FRiderPathLocator::GetInstallInfosFromResourceFile()
 		const FString Location = RiderLocation.TrimStartAndEnd();
 		if(Location.StartsWith("#")) continue;
 		
-		TOptional<FInstallInfo> InstallInfo = GetInstallInfoFromRiderPath(Location, FInstallInfo::EInstallType::Custom);
+		TOptional<FInstallInfo> InstallInfo = Context.Probe(Location, FInstallInfo::EInstallType::Custom);
 		if(InstallInfo.IsSet())
 		{
 			RiderInstallInfos.Add(InstallInfo.GetValue());
@@ -187,3 +255,176 @@ TArray<FInstallInfo> FRiderPathLocator::GetInstallInfosFromResourceFile()
 	}
 	return RiderInstallInfos;
 }
+
+static FString GetSourceYieldsPath()
+{
+	return FPaths::Combine(FPlatformProcess::UserTempDir(), TEXT("RiderSourceCodeAccess"), TEXT("SourceYields.txt"));
+}
+
+/** Number of installs each source found during the last complete discovery on this machine */
+static TMap<FName, int32> LoadSourceYields()
+{
+	TMap<FName, int32> SourceYields;
+	TArray<FString> Lines;
+	FFileHelper::LoadFileToStringArray(Lines, *GetSourceYieldsPath());
+	for (const FString& Line : Lines)
+	{
+		FString Name, Count;
+		if (Line.Split(TEXT("="), &Name, &Count))
+		{
+			SourceYields.Add(*Name, FCString::Atoi(*Count));
+		}
+	}
+	return SourceYields;
+}
+
+static void SaveSourceYields(const FDiscoveryStats& Stats, const TMap<FName, int32>& PreviousYields)
+{
+	TMap<FName, int32> SourceYields;
+	for (const FDiscoveryStats::FSourceStats& SourceStats : Stats.Sources)
+	{
+		SourceYields.Add(SourceStats.Name, SourceStats.NumInstalls);
+	}
+	if (SourceYields.OrderIndependentCompareEqual(PreviousYields)) return;
+
+	TArray<FString> Lines;
+	for (const TPair<FName, int32>& SourceYield : SourceYields)
+	{
+		Lines.Add(FString::Printf(TEXT("%s=%d"), *SourceYield.Key.ToString(), SourceYield.Value));
+	}
+
+	// Every editor on the machine reads and writes this file, write aside and move into place so none reads a partial one
+	const FString SourceYieldsPath = GetSourceYieldsPath();
+	const FString TempPath = SourceYieldsPath + TEXT(".") + FGuid::NewGuid().ToString();
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *TempPath)) return;
+	if (!IFileManager::Get().Move(*SourceYieldsPath, *TempPath, true, true))
+	{
+		IFileManager::Get().Delete(*TempPath);
+	}
+}
+
+TSet<FInstallInfo> FRiderPathLocator::MergeInSourceOrder(const TMap<int32, TArray<FInstallInfo>>& SourceInstallInfos)
+{
+	TArray<int32> SourceIndices;
+	SourceInstallInfos.GetKeys(SourceIndices);
+	SourceIndices.Sort();
+
+	// Adding replaces an equal install, so the source listed last names an install several sources found, as before ordering by yield
+	TSet<FInstallInfo> InstallInfos;
+	for (const int32 SourceIndex : SourceIndices)
+	{
+		InstallInfos.Append(SourceInstallInfos[SourceIndex]);
+	}
+	return InstallInfos;
+}
+
+TSet<FInstallInfo> FRiderPathLocator::CollectAllPaths(FDiscoveryStats* OutStats)
+{
+	return CollectAllPaths(OutStats, true, [](int32, const TArray<FInstallInfo>&) {});
+}
+
+TSet<FInstallInfo> FRiderPathLocator::CollectAllPaths(FDiscoveryStats* OutStats, bool bSaveSourceYields, TFunctionRef<void(int32, const TArray<FInstallInfo>&)> OnSourceCollected)
+{
+	SCOPED_NAMED_EVENT(FRiderPathLocator_CollectAllPaths, FColor::Turquoise);
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Sources that found installs here last time go first, so a time budget is spent where installs actually are
+	const TArray<FDiscoverySource> Sources = GetDiscoverySources();
+	const TMap<FName, int32> SourceYields = LoadSourceYields();
+	TArray<int32> SourceOrder;
+	for (int32 SourceIndex = 0; SourceIndex < Sources.Num(); SourceIndex++)
+	{
+		SourceOrder.Add(SourceIndex);
+	}
+	SourceOrder.StableSort([&Sources, &SourceYields](int32 Left, int32 Right)
+	{
+		return SourceYields.FindRef(Sources[Left].Name) > SourceYields.FindRef(Sources[Right].Name);
+	});
+
+	FDiscoveryStats Stats;
+	FDiscoveryContext Context;
+	TMap<int32, TArray<FInstallInfo>> SourceInstallInfos;
+	for (const int32 SourceIndex : SourceOrder)
+	{
+		const FDiscoverySource& Source = Sources[SourceIndex];
+		SCOPED_NAMED_EVENT_FSTRING(Source.Name.ToString(), FColor::Turquoise);
+		const double SourceStartTime = FPlatformTime::Seconds();
+		const TArray<FInstallInfo>& CollectedInstallInfos = SourceInstallInfos.Add(SourceIndex, Source.Collect(Context));
+		OnSourceCollected(SourceIndex, CollectedInstallInfos);
+
+		FDiscoveryStats::FSourceStats& SourceStats = Stats.Sources.AddDefaulted_GetRef();
+		SourceStats.Name = Source.Name;
+		SourceStats.Seconds = FPlatformTime::Seconds() - SourceStartTime;
+		SourceStats.NumInstalls = CollectedInstallInfos.Num();
+	}
+	Stats.TotalSeconds = FPlatformTime::Seconds() - StartTime;
+	Stats.NumProbes = Context.GetNumProbes();
+
+	if (bSaveSourceYields)
+	{
+		SaveSourceYields(Stats, SourceYields);
+	}
+	if (OutStats != nullptr)
+	{
+		*OutStats = MoveTemp(Stats);
+	}
+	return MergeInSourceOrder(SourceInstallInfos);
+}
+
+FBudgetedDiscoveryResult FRiderPathLocator::CollectAllPathsWithinBudget(double TimeBudgetSeconds)
+{
+	struct FProgress
+	{
+		FCriticalSection CriticalSection;
+		TMap<int32, TArray<FInstallInfo>> SourceInstallInfos;
+	};
+	const TSharedRef<FProgress, ESPMode::ThreadSafe> Progress = MakeShared<FProgress, ESPMode::ThreadSafe>();
+
+	TFuture<TSet<FInstallInfo>> Future = Async(EAsyncExecution::ThreadPool, [Progress]()
+	{
+		return CollectAllPaths(nullptr, true, [&Progress](int32 SourceIndex, const TArray<FInstallInfo>& SourceInstallInfos)
+		{
+			FScopeLock Lock(&Progress->CriticalSection);
+			Progress->SourceInstallInfos.Add(SourceIndex, SourceInstallInfos);
+		});
+	});
+
+	FBudgetedDiscoveryResult Result;
+	if (Future.WaitFor(FTimespan::FromSeconds(TimeBudgetSeconds)))
+	{
+		Result.InstallInfos = Future.Get();
+		return Result;
+	}
+
+	{
+		FScopeLock Lock(&Progress->CriticalSection);
+		Result.InstallInfos = MergeInSourceOrder(Progress->SourceInstallInfos);
+	}
+	Result.Remaining = MoveTemp(Future);
+	return Result;
+}
+
+TOptional<FInstallInfo> FDiscoveryContext::Probe(const FString& Path, FInstallInfo::EInstallType InstallType)
+{
+	const FString CanonicalPath = FRiderPathLocator::GetCanonicalPath(Path);
+	if (const FInstallInfo* ProbedInstall = ProbedInstalls.Find(CanonicalPath))
+	{
+		// Keep the path of the first hit so every source reports the same install, but let the latest source name its type
+		FInstallInfo InstallInfo = *ProbedInstall;
+		InstallInfo.InstallType = InstallType;
+		return InstallInfo;
+	}
+	if (FailedProbes.Contains(Path)) return {};
+
+	NumProbes++;
+	const TOptional<FInstallInfo> InstallInfo = FRiderPathLocator::GetInstallInfoFromRiderPath(Path, InstallType);
+	if (InstallInfo.IsSet())
+	{
+		ProbedInstalls.Add(CanonicalPath, InstallInfo.GetValue());
+	}
+	else
+	{
+		FailedProbes.Add(Path);
+	}
+	return InstallInfo;
+}
@@ -0,0 +1,153 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderPathLocator/RiderPathLocator.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRiderBenchmark, Log, All);
+
+/**
+ * Generates synthetic Rider install trees and runs the locator stages against them.
+ * Usage: Rider.Benchmark.Discovery [NumInstalls=50] [PluginDepth=4]
+ * Runs headless, e.g. UnrealEditor-Cmd <Project> -unattended -nullrhi -ExecCmds="Rider.Benchmark.Discovery 500 8, Quit"
+ * Add -trace=cpu,memalloc to capture per-stage events and allocations in Unreal Insights.
+ */
+class FRiderPathLocatorBenchmark
+{
+public:
+	static void Run(int32 NumInstalls, int32 PluginDepth)
+	{
+		const FString Root = FPaths::Combine(FPlatformProcess::UserTempDir(), TEXT("RiderLocatorBenchmark"), FGuid::NewGuid().ToString());
+		UE_LOG(LogRiderBenchmark, Display, TEXT("Generating %d synthetic installs (plugin depth %d) in %s"), NumInstalls, PluginDepth, *Root);
+
+		const FString ToolboxV1Root = FPaths::Combine(Root, TEXT("ToolboxV1"));
+		const FString ToolboxV2Root = FPaths::Combine(Root, TEXT("ToolboxV2"));
+		const FString OptRoot = FPaths::Combine(Root, TEXT("opt"));
+		const FString RiderLocationsFile = FPaths::Combine(Root, TEXT("RiderLocations.txt"));
+
+		TArray<FString> OptLaunchers;
+		TArray<FString> ToolboxStateEntries;
+		for (int32 Index = 0; Index < NumInstalls; Index++)
+		{
+			const FString Build = FString::Printf(TEXT("%d.%d.%d"), 221 + Index % 20, 1000 + Index, Index % 100);
+			const FString ChannelDir = FPaths::Combine(ToolboxV1Root, TEXT("apps"), TEXT("Rider"), FString::Printf(TEXT("ch-%d"), Index));
+			GenerateInstall(FPaths::Combine(ChannelDir, Build), Build, PluginDepth);
+			WriteHistoryJson(ChannelDir, Build);
+
+			const FString ToolboxV2InstallDir = FPaths::Combine(ToolboxV2Root, FString::Printf(TEXT("Rider %d"), Index));
+			FString LaunchCommand = GenerateInstall(ToolboxV2InstallDir, Build, PluginDepth);
+			FPaths::MakePathRelativeTo(LaunchCommand, *(ToolboxV2InstallDir + TEXT("/")));
+			ToolboxStateEntries.Add(FString::Printf(TEXT("{\"toolId\": \"Rider\", \"buildNumber\": \"%s\", \"installLocation\": \"%s\", \"launchCommand\": \"%s\"}"),
+				*Build, *ToolboxV2InstallDir, *LaunchCommand));
+			OptLaunchers.Add(GenerateInstall(FPaths::Combine(OptRoot, FString::Printf(TEXT("Rider-%d"), Index)), Build, PluginDepth));
+		}
+		FFileHelper::SaveStringArrayToFile(OptLaunchers, *RiderLocationsFile);
+		FFileHelper::SaveStringToFile(FString::Printf(TEXT("{\"tools\": [%s]}"), *FString::Join(ToolboxStateEntries, TEXT(", "))), *FPaths::Combine(ToolboxV2Root, TEXT("state.json")));
+
+		Measure(TEXT("ToolboxV1"), [&ToolboxV1Root](FDiscoveryContext& Context) { return FRiderPathLocator::GetInstallInfos(Context, FPaths::Combine(ToolboxV1Root, TEXT("apps")), GetPattern(), FInstallInfo::EInstallType::Toolbox); });
+		Measure(TEXT("ToolboxV2"), [&ToolboxV2Root](FDiscoveryContext& Context) { return FRiderPathLocator::GetInstallInfos(Context, ToolboxV2Root, GetPattern(), FInstallInfo::EInstallType::Toolbox); });
+		Measure(TEXT("ToolboxState"), [&ToolboxV2Root](FDiscoveryContext& Context) { return FRiderPathLocator::GetInstallInfosFromToolboxState(Context, ToolboxV2Root).Get({}); });
+		Measure(TEXT("Opt"), [&OptLaunchers](FDiscoveryContext& Context)
+		{
+			TArray<FInstallInfo> Result;
+			for (const FString& Launcher : OptLaunchers)
+			{
+				TOptional<FInstallInfo> InstallInfo = Context.Probe(GetProbePath(Launcher), FInstallInfo::EInstallType::Installed);
+				if (InstallInfo.IsSet())
+				{
+					Result.Add(InstallInfo.GetValue());
+				}
+			}
+			return Result;
+		});
+		Measure(TEXT("RiderLocations"), [&RiderLocationsFile](FDiscoveryContext& Context) { return FRiderPathLocator::GetInstallInfosFromLocationsFile(Context, RiderLocationsFile); });
+
+		IFileManager::Get().DeleteDirectory(*Root, false, true);
+
+		// Leaves the source yields alone, benchmark runs shouldn't reorder the sources of real discovery
+		FDiscoveryStats Stats;
+		const int32 NumFound = FRiderPathLocator::CollectAllPaths(&Stats, false, [](int32, const TArray<FInstallInfo>&) {}).Num();
+		for (const FDiscoveryStats::FSourceStats& SourceStats : Stats.Sources)
+		{
+			UE_LOG(LogRiderBenchmark, Display, TEXT("  Host source %-36s %9.3f ms, %d installs"), *SourceStats.Name.ToString(), SourceStats.Seconds * 1000.0, SourceStats.NumInstalls);
+		}
+		UE_LOG(LogRiderBenchmark, Display, TEXT("CollectAllPaths on this machine: %.3f ms, %d installs, %d probes"), Stats.TotalSeconds * 1000.0, NumFound, Stats.NumProbes);
+	}
+
+private:
+	static void Measure(const TCHAR* StageName, TFunctionRef<TArray<FInstallInfo>(FDiscoveryContext&)> Stage)
+	{
+		FDiscoveryContext Context;
+		const double StartTime = FPlatformTime::Seconds();
+		const int32 NumFound = Stage(Context).Num();
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+		UE_LOG(LogRiderBenchmark, Display, TEXT("  Synthetic %-16s %9.3f ms, %d installs, %d probes"), StageName, Seconds * 1000.0, NumFound, Context.GetNumProbes());
+	}
+
+	static FString GetPattern()
+	{
+#if PLATFORM_WINDOWS
+		return TEXT("rider64.exe");
+#elif PLATFORM_MAC
+		return TEXT("Rider*.app");
+#else
+		return TEXT("rider.sh");
+#endif
+	}
+
+	static FString GetProbePath(const FString& Launcher)
+	{
+#if PLATFORM_MAC
+		// Mac locator expects the path to Rider.app, which is three levels above the launcher
+		return FPaths::GetPath(FPaths::GetPath(FPaths::GetPath(Launcher)));
+#else
+		return Launcher;
+#endif
+	}
+
+	/** Creates the minimal layout accepted by GetInstallInfoFromRiderPath and returns the launcher path */
+	static FString GenerateInstall(const FString& InstallDir, const FString& Build, int32 PluginDepth)
+	{
+#if PLATFORM_MAC
+		const FString ContentsDir = FPaths::Combine(InstallDir, TEXT("Rider.app"), TEXT("Contents"));
+		const FString Launcher = FPaths::Combine(ContentsDir, TEXT("MacOS"), TEXT("rider"));
+		const FString ProductInfoJsonPath = FPaths::Combine(ContentsDir, TEXT("Resources"), TEXT("product-info.json"));
+#else
+		const FString ContentsDir = InstallDir;
+		const FString Launcher = FPaths::Combine(ContentsDir, TEXT("bin"), GetPattern());
+		const FString ProductInfoJsonPath = FPaths::Combine(ContentsDir, TEXT("product-info.json"));
+#endif
+		FFileHelper::SaveStringToFile(TEXT(""), *Launcher);
+		FFileHelper::SaveStringToFile(FString::Printf(TEXT("{\"buildNumber\": \"%s\"}"), *Build), *ProductInfoJsonPath);
+
+		FString PluginDir = FPaths::Combine(ContentsDir, TEXT("plugins"), TEXT("rider-cpp"));
+		for (int32 Depth = 0; Depth < PluginDepth; Depth++)
+		{
+			PluginDir = FPaths::Combine(PluginDir, FString::Printf(TEXT("lib%d"), Depth));
+			FFileHelper::SaveStringToFile(TEXT(""), *FPaths::Combine(PluginDir, TEXT("plugin.jar")));
+		}
+		return Launcher;
+	}
+
+	static void WriteHistoryJson(const FString& ChannelDir, const FString& Build)
+	{
+		const FString HistoryJson = FString::Printf(TEXT("{\"history\": [{\"item\": {\"build\": \"%s\"}}]}"), *Build);
+		FFileHelper::SaveStringToFile(HistoryJson, *FPaths::Combine(ChannelDir, TEXT(".history.json")));
+	}
+};
+
+static FAutoConsoleCommand RiderDiscoveryBenchmarkCommand(
+	TEXT("Rider.Benchmark.Discovery"),
+	TEXT("Generates synthetic Rider installs and measures locator stages. Args: [NumInstalls=50] [PluginDepth=4]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumInstalls = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 1, 500) : 50;
+		const int32 PluginDepth = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 0) : 4;
+		FRiderPathLocatorBenchmark::Run(NumInstalls, PluginDepth);
+	}));
@@ -13,12 +13,25 @@
 
 #include "Runtime/Launch/Resources/Version.h"
 
+#include <limits.h>
+#include <stdlib.h>
+
 FString FRiderPathLocator::GetDefaultIDEInstallLocationForToolboxV2()
 {
 	// V2 and V1 have the same path on Linux, we don't need to process it extra
 	return {};
 }
 
+FString FRiderPathLocator::GetCanonicalPath(const FString& Path)
+{
+	char ResolvedPath[PATH_MAX];
+	if (realpath(TCHAR_TO_UTF8(*Path), ResolvedPath) != nullptr)
+	{
+		return UTF8_TO_TCHAR(ResolvedPath);
+	}
+	return FPaths::ConvertRelativePathToFull(Path);
+}
+
 TOptional<FInstallInfo> FRiderPathLocator::GetInstallInfoFromRiderPath(const FString& Path, FInstallInfo::EInstallType InstallType)
 {
 	if(!FPaths::FileExists(Path))
@@ -41,9 +54,15 @@ TOptional<FInstallInfo> FRiderPathLocator::GetInstallInfoFromRiderPath(const FSt
 		return {};
 	}
 	
-	FInstallInfo Info;
-	Info.Path = Path;
-	Info.InstallType = InstallType;
+	FInstallInfo Info(Path, InstallType);
+
+	// Since 2023.2 rider.sh only execs bin/rider, which sets up its own environment
+	const FString NativeLauncherPath = FPaths::Combine(RiderDir, TEXT("bin"), TEXT("rider"));
+	if (FPaths::GetCleanFilename(Path) == TEXT("rider.sh") && FPaths::FileExists(NativeLauncherPath))
+	{
+		Info.NativeLauncherPath = NativeLauncherPath;
+	}
+
 	const FString ProductInfoJsonPath = FPaths::Combine(RiderDir, TEXT("product-info.json"));
 	if (FPaths::FileExists(ProductInfoJsonPath))
 	{
@@ -73,7 +92,7 @@ static FString GetHomePath()
 	return FHomePath;
 }
 
-static TArray<FInstallInfo> GetManuallyInstalledRiders()
+static TArray<FInstallInfo> GetManuallyInstalledRiders(FDiscoveryContext& Context)
 {
 	TArray<FInstallInfo> Result;
 	TArray<FString> RiderPaths;
@@ -92,7 +111,7 @@ static TArray<FInstallInfo> GetManuallyInstalledRiders()
 		for(const FString& RiderPath: RiderPaths)
 		{
 			FString FullPath = FPaths::Combine(RiderLookupPath, RiderPath, TEXT("bin"), TEXT("rider.sh"));
-			TOptional<FInstallInfo> InstallInfo = FRiderPathLocator::GetInstallInfoFromRiderPath(FullPath, FInstallInfo::EInstallType::Installed);
+			TOptional<FInstallInfo> InstallInfo = Context.Probe(FullPath, FInstallInfo::EInstallType::Installed);
 			if(InstallInfo.IsSet())
 			{
 				Result.Add(InstallInfo.GetValue());
@@ -102,7 +121,7 @@ static TArray<FInstallInfo> GetManuallyInstalledRiders()
 	}
 
 	FString FullPath = TEXT("/snap/rider/current/bin/rider.sh");
-	TOptional<FInstallInfo> InstallInfo = FRiderPathLocator::GetInstallInfoFromRiderPath(FullPath, FInstallInfo::EInstallType::Installed);
+	TOptional<FInstallInfo> InstallInfo = Context.Probe(FullPath, FInstallInfo::EInstallType::Installed);
 	if(InstallInfo.IsSet())
 	{
 		Result.Add(InstallInfo.GetValue());
@@ -119,7 +138,7 @@ static FString GetToolboxPath()
 	return FPaths::Combine(LocalAppData, TEXT("JetBrains"), TEXT("Toolbox"));
 }
 
-static TArray<FInstallInfo> GetInstalledRidersWithLocate()
+static TArray<FInstallInfo> GetInstalledRidersWithLocate(FDiscoveryContext& Context)
 {
 	int32 ReturnCode;
 	FString OutResults;
@@ -149,7 +168,7 @@ static TArray<FInstallInfo> GetInstalledRidersWithLocate()
 	TArray<FInstallInfo> Result;
 	for(const FString& RiderPath: RiderPaths)
 	{
-		TOptional<FInstallInfo> InstallInfo = FRiderPathLocator::GetInstallInfoFromRiderPath(RiderPath, FInstallInfo::EInstallType::Installed);
+		TOptional<FInstallInfo> InstallInfo = Context.Probe(RiderPath, FInstallInfo::EInstallType::Installed);
 		if(InstallInfo.IsSet())
 		{
 			Result.Add(InstallInfo.GetValue());
@@ -158,13 +177,13 @@ static TArray<FInstallInfo> GetInstalledRidersWithLocate()
 	return Result;
 }
 
-TSet<FInstallInfo> FRiderPathLocator::CollectAllPaths()
+TArray<FDiscoverySource> FRiderPathLocator::GetDiscoverySources()
 {
-	TSet<FInstallInfo> InstallInfos;
-	InstallInfos.Append(GetInstalledRidersWithLocate());
-	InstallInfos.Append(GetManuallyInstalledRiders());
-	InstallInfos.Append(GetInstallInfosFromToolbox(GetToolboxPath(), "Rider.sh"));
-	InstallInfos.Append(GetInstallInfosFromResourceFile());
-	return InstallInfos;
+	return {
+		{ TEXT("Locate"), [](FDiscoveryContext& Context) { return GetInstalledRidersWithLocate(Context); } },
+		{ TEXT("Manual"), [](FDiscoveryContext& Context) { return GetManuallyInstalledRiders(Context); } },
+		{ TEXT("Toolbox"), [](FDiscoveryContext& Context) { return GetInstallInfosFromToolbox(Context, GetToolboxPath(), "Rider.sh"); } },
+		{ TEXT("ResourceFile"), [](FDiscoveryContext& Context) { return GetInstallInfosFromResourceFile(Context); } }
+	};
 }
 #endif
@@ -12,6 +12,19 @@
 
 #include "Runtime/Launch/Resources/Version.h"
 
+#include <limits.h>
+#include <stdlib.h>
+
+FString FRiderPathLocator::GetCanonicalPath(const FString& Path)
+{
+	char ResolvedPath[PATH_MAX];
+	if (realpath(TCHAR_TO_UTF8(*Path), ResolvedPath) != nullptr)
+	{
+		return UTF8_TO_TCHAR(ResolvedPath);
+	}
+	return FPaths::ConvertRelativePathToFull(Path);
+}
+
 TOptional<FInstallInfo> FRiderPathLocator::GetInstallInfoFromRiderPath(const FString& PathToRiderApp, FInstallInfo::EInstallType InstallType)
 {
 	if(!DirectoryExistsAndNonEmpty(PathToRiderApp))
@@ -25,9 +38,7 @@ TOptional<FInstallInfo> FRiderPathLocator::GetInstallInfoFromRiderPath(const FSt
 		return {};
 	}
 
-	FInstallInfo Info;
-	Info.Path = FPaths::Combine(PathToRiderApp, TEXT("Contents"), TEXT("MacOS"), TEXT("rider"));
-	Info.InstallType = InstallType;
+	FInstallInfo Info(FPaths::Combine(PathToRiderApp, TEXT("Contents"), TEXT("MacOS"), TEXT("rider")), InstallType);
 	const FString ProductInfoJsonPath = FPaths::Combine(PathToRiderApp, TEXT("Contents"), TEXT("Resources"), TEXT("product-info.json"));
 	if (FPaths::FileExists(ProductInfoJsonPath))
 	{
@@ -36,7 +47,7 @@ TOptional<FInstallInfo> FRiderPathLocator::GetInstallInfoFromRiderPath(const FSt
 	return Info;
 }
 
-static TArray<FInstallInfo> GetManuallyInstalledRiders()
+static TArray<FInstallInfo> GetManuallyInstalledRiders(FDiscoveryContext& Context)
 {
 	TArray<FInstallInfo> Result;
 	TArray<FString> RiderPaths;
@@ -44,7 +55,7 @@ static TArray<FInstallInfo> GetManuallyInstalledRiders()
 	for(const FString& RiderPath: RiderPaths)
 	{
 		FString FullPath = TEXT("/Applications/") + RiderPath;
-		TOptional<FInstallInfo> InstallInfo = FRiderPathLocator::GetInstallInfoFromRiderPath(FullPath, FInstallInfo::EInstallType::Installed);
+		TOptional<FInstallInfo> InstallInfo = Context.Probe(FullPath, FInstallInfo::EInstallType::Installed);
 		if(InstallInfo.IsSet())
 		{
 			Result.Add(InstallInfo.GetValue());
@@ -68,7 +79,7 @@ static FString GetToolboxPath()
 	return FPaths::Combine(LocalAppData, TEXT("JetBrains"), TEXT("Toolbox"));
 }
 
-static TArray<FInstallInfo> GetInstalledRidersWithMdfind()
+static TArray<FInstallInfo> GetInstalledRidersWithMdfind(FDiscoveryContext& Context)
 {
 	int32 ReturnCode;
 	FString OutResults;
@@ -98,7 +109,7 @@ static TArray<FInstallInfo> GetInstalledRidersWithMdfind()
 	TArray<FInstallInfo> Result;
 	for(const FString& RiderPath: RiderPaths)
 	{
-		TOptional<FInstallInfo> InstallInfo = FRiderPathLocator::GetInstallInfoFromRiderPath(RiderPath, FInstallInfo::EInstallType::Installed);
+		TOptional<FInstallInfo> InstallInfo = Context.Probe(RiderPath, FInstallInfo::EInstallType::Installed);
 		if(InstallInfo.IsSet())
 		{
 			Result.Add(InstallInfo.GetValue());
@@ -119,13 +130,13 @@ FString FRiderPathLocator::GetDefaultIDEInstallLocationForToolboxV2()
 	return FPaths::Combine(FHomePath, TEXT("Applications"));
 }
 
-TSet<FInstallInfo> FRiderPathLocator::CollectAllPaths()
+TArray<FDiscoverySource> FRiderPathLocator::GetDiscoverySources()
 {
-	TSet<FInstallInfo> InstallInfos;
-	InstallInfos.Append(GetInstalledRidersWithMdfind());
-	InstallInfos.Append(GetManuallyInstalledRiders());
-	InstallInfos.Append(GetInstallInfosFromToolbox(GetToolboxPath(), "Rider*.app"));
-	InstallInfos.Append(GetInstallInfosFromResourceFile());
-	return InstallInfos;
+	return {
+		{ TEXT("Mdfind"), [](FDiscoveryContext& Context) { return GetInstalledRidersWithMdfind(Context); } },
+		{ TEXT("Manual"), [](FDiscoveryContext& Context) { return GetManuallyInstalledRiders(Context); } },
+		{ TEXT("Toolbox"), [](FDiscoveryContext& Context) { return GetInstallInfosFromToolbox(Context, GetToolboxPath(), "Rider*.app"); } },
+		{ TEXT("ResourceFile"), [](FDiscoveryContext& Context) { return GetInstallInfosFromResourceFile(Context); } }
+	};
 }
 #endif
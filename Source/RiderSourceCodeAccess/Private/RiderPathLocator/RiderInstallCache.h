@@ -0,0 +1,45 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "RiderPathLocator/RiderPathLocator.h"
+
+/**
+ * Discovery results shared between processes through a memory-mapped file in the user temp directory.
+ * The first process to start claims discovery and publishes the result once it is complete; processes starting
+ * meanwhile wait for it and map the file read-only instead of walking the filesystem themselves.
+ * Each RiderLocations.txt gets its own file, engines listing different custom locations don't share results.
+ */
+class FRiderInstallCache
+{
+public:
+	/**
+	 * Returns cached installs if the cache is younger than LifetimeSeconds, otherwise runs Collect and publishes its result.
+	 * While another process is discovering, waits up to WaitSeconds for its result before running Collect anyway.
+	 * Collect clears bOutComplete when it returns partial results, which are handed back but not published: the
+	 * caller publishes the complete result once its background discovery finishes.
+	 */
+	static TArray<FInstallInfo> LoadOrCollect(int32 LifetimeSeconds, double WaitSeconds, TFunctionRef<TArray<FInstallInfo>(bool& bOutComplete)> Collect);
+
+	/** Saves a complete discovery result and releases this process' claim on discovery, if it made one. Empty results are shared only briefly */
+	static bool Publish(const TArray<FInstallInfo>& InstallInfos);
+
+	/** Maps the cache read-only. Fails if it is missing, from another format version, expired or lists a launcher that is gone */
+	static TOptional<TArray<FInstallInfo>> Load(int32 LifetimeSeconds);
+
+	static bool Save(const TArray<FInstallInfo>& InstallInfos);
+
+	/** The cache file's contents, also used to hand installs over to a reloaded module */
+	static TArray<uint8> Serialize(const TArray<FInstallInfo>& InstallInfos);
+	static TOptional<TArray<FInstallInfo>> Deserialize(TArrayView<const uint8> Data, int32 LifetimeSeconds);
+
+	static FString GetCachePath();
+
+private:
+	/** Marks discovery as running in this process, so others wait for its result instead of starting their own */
+	static FString GetPendingPath();
+	static void ClaimDiscovery();
+	static void ReleaseClaim();
+	static bool ReadClaim(uint32& OutProcessId, FTimespan& OutAge);
+	static bool IsDiscoveryPendingElsewhere();
+};
@@ -3,11 +3,13 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Misc/Optional.h"
 #include "Misc/Paths.h"
 
 struct FVersion
 {	
-	bool IsInitialized() const { return Versions.Num() != 0; }
+	bool IsInitialized() const { return NumComponents != 0; }
 
 	FVersion(){}
 
@@ -18,74 +20,129 @@ struct FVersion
 
 	void operator=(const FString& VersionString)
 	{
-		TArray<FString> Output;
-		VersionString.ParseIntoArray(Output, TEXT("."));
-		for (const FString& Item : Output)
+		// Single pass over the string, same result as splitting by '.', dropping empty items and running Atoi on each
+		NumComponents = 0;
+		const TCHAR* Cursor = *VersionString;
+		while (*Cursor != TEXT('\0'))
 		{
-			Versions.Add(FCString::Atoi(*Item));
-		}		
+			const TCHAR* ItemEnd = Cursor;
+			while (*ItemEnd != TEXT('\0') && *ItemEnd != TEXT('.')) ItemEnd++;
+
+			if (ItemEnd != Cursor && NumComponents < MAX_COMPONENTS)
+			{
+				Components[NumComponents++] = ParseComponent(Cursor, ItemEnd);
+			}
+			Cursor = (*ItemEnd == TEXT('.')) ? ItemEnd + 1 : ItemEnd;
+		}
 	}
 
 	int32 Major() const
 	{
-		if(Versions.Num() >= 1)
+		if(NumComponents >= 1)
 		{
-			return Versions[0];
+			return Components[0];
 		}
 		return INVALID_VERSION;
 	}
 
 	int32 Minor() const
 	{
-		if(Versions.Num() >= 2)
+		if(NumComponents >= 2)
 		{
-			return Versions[1];
+			return Components[1];
 		}
 		return INVALID_VERSION;
 	}
 
 	int32 Patch() const
 	{
-		if(Versions.Num() >= 3)
+		if(NumComponents >= 3)
 		{
-			return Versions[2];
+			return Components[2];
 		}
 		return INVALID_VERSION;
 	}
 
-	bool operator<(const FVersion& rhs) const
+	/** Three-way compare: negative if this is older than rhs, zero if equal, positive if newer */
+	int32 Compare(const FVersion& rhs) const
 	{
-		TArray<int32>::SizeType LeftSize = Versions.Num();
-		TArray<int32>::SizeType RightSize = rhs.Versions.Num();
-		const TArray<int32>::SizeType Size = (LeftSize >= RightSize) ? RightSize : LeftSize;
-		for(TArray<int32>::SizeType Index = 0; Index < Size; Index++)
+		const int32 Size = FMath::Min(NumComponents, rhs.NumComponents);
+		for(int32 Index = 0; Index < Size; Index++)
 		{
-			const int32 LeftElement = Versions[Index];
-			const int32 RightElement = rhs.Versions[Index];
-			if(LeftElement < RightElement) return true;
-			if(LeftElement > RightElement) return false;
+			if(Components[Index] != rhs.Components[Index])
+			{
+				return Components[Index] < rhs.Components[Index] ? -1 : 1;
+			}
 		}
-		return LeftSize < RightSize;
+		return NumComponents - rhs.NumComponents;
+	}
+
+	bool operator<(const FVersion& rhs) const
+	{
+		return Compare(rhs) < 0;
 	}
 
 	bool operator==(const FVersion& rhs) const
 	{
-		return !(*this < rhs) && !(rhs < *this); 
+		return Compare(rhs) == 0;
 	}
 
 	bool operator!=(const FVersion& rhs) const
 	{
-		return (*this < rhs) || (rhs < *this); 
+		return Compare(rhs) != 0;
+	}
+
+	TArrayView<const int32> GetComponents() const
+	{
+		return TArrayView<const int32>(Components, NumComponents);
+	}
+
+	static FVersion FromComponents(TArrayView<const int32> InComponents)
+	{
+		FVersion Version;
+		Version.NumComponents = FMath::Min(InComponents.Num(), MAX_COMPONENTS);
+		FMemory::Memcpy(Version.Components, InComponents.GetData(), Version.NumComponents * sizeof(int32));
+		return Version;
 	}
 
 	FString ToString() const
 	{
-		return FString::JoinBy(Versions, TEXT("."), [](int32 Item)-> FString { return FString::FromInt(Item); });
+		FString Result;
+		for(int32 Index = 0; Index < NumComponents; Index++)
+		{
+			if(Index != 0) Result += TEXT(".");
+			Result.AppendInt(Components[Index]);
+		}
+		return Result;
 	}
 
-	
-	TArray<int32> Versions;
 	static const int32 INVALID_VERSION = -1;
+
+	/** Components kept per version, enough for any Rider version or build number (e.g. 233.14475.56), extra ones are ignored */
+	static const int32 MAX_COMPONENTS = 6;
+
+private:
+	static int32 ParseComponent(const TCHAR* Begin, const TCHAR* End)
+	{
+		while (Begin != End && FChar::IsWhitespace(*Begin)) Begin++;
+
+		bool bNegative = false;
+		if (Begin != End && (*Begin == TEXT('-') || *Begin == TEXT('+')))
+		{
+			bNegative = *Begin == TEXT('-');
+			Begin++;
+		}
+
+		int32 Value = 0;
+		for (; Begin != End && FChar::IsDigit(*Begin); Begin++)
+		{
+			Value = Value * 10 + (*Begin - TEXT('0'));
+		}
+		return bNegative ? -Value : Value;
+	}
+
+	int32 Components[MAX_COMPONENTS] = {};
+	int32 NumComponents = 0;
 };
 
 struct FInstallInfo
@@ -104,13 +161,32 @@ struct FInstallInfo
 		Custom
 	};
 	
-	FString Path;
 	FVersion Version;
 	ESupportUproject SupportUprojectState = ESupportUproject::None;
 	EInstallType InstallType;
 
+	/** Native launcher of an install whose path is a script wrapper, launching it directly saves a shell. Empty if there is none */
+	FString NativeLauncherPath;
+
 	FInstallInfo() = default;
 
+	FInstallInfo(const FString& InPath, EInstallType InInstallType)
+		: InstallType(InInstallType)
+	{
+		SetPath(InPath);
+	}
+
+	const FString& GetPath() const { return Path; }
+
+	void SetPath(const FString& InPath)
+	{
+		Path = InPath;
+		NormalizedPath = InPath;
+		NormalizedPath.ReplaceInline(TEXT("\\\\"), TEXT("/"), ESearchCase::CaseSensitive);
+		FPaths::NormalizeFilename(NormalizedPath);
+		PathHash = GetTypeHash(NormalizedPath);
+	}
+
 	bool operator<(const FInstallInfo& InstallInfo) const
 	{
 		return Version < InstallInfo.Version;
@@ -118,38 +194,114 @@ struct FInstallInfo
 
 	bool operator==(const FInstallInfo& InstallInfo) const
 	{
-		FString LocalPath = Path;
-		FString InputPath = InstallInfo.Path;
-		LocalPath.ReplaceInline(TEXT("\\\\"), TEXT("/"), ESearchCase::CaseSensitive);
-		FPaths::NormalizeFilename(LocalPath);
-		InputPath.ReplaceInline(TEXT("\\\\"), TEXT("/"), ESearchCase::CaseSensitive);
-		FPaths::NormalizeFilename(InputPath);
-		return !(*this < InstallInfo) && !(InstallInfo < *this) && (LocalPath == InputPath);
+		return PathHash == InstallInfo.PathHash && Version == InstallInfo.Version && NormalizedPath == InstallInfo.NormalizedPath;
 	}
     
     friend FORCEINLINE uint32 GetTypeHash(const FInstallInfo& InstallInfo)
     {
-		FString LocalPath = InstallInfo.Path;
-		LocalPath.ReplaceInline(TEXT("\\\\"), TEXT("/"), ESearchCase::CaseSensitive);
-		FPaths::NormalizeFilename(LocalPath);
-        return GetTypeHash(LocalPath);
+        return InstallInfo.PathHash;
     }
+
+private:
+	FString Path;
+
+	/** Path with separators normalized, computed once so hashing and comparison don't allocate */
+	FString NormalizedPath;
+	uint32 PathHash = 0;
+};
+
+/** State shared by all discovery sources during a single CollectAllPaths run */
+class FDiscoveryContext
+{
+public:
+	/** Probes the install behind Path once per run, however many sources and symlinks lead to it */
+	TOptional<FInstallInfo> Probe(const FString& Path, FInstallInfo::EInstallType InstallType);
+
+	int32 GetNumProbes() const { return NumProbes; }
+
+private:
+	/** Installs found, keyed by canonical launcher path */
+	TMap<FString, FInstallInfo> ProbedInstalls;
+
+	/**
+	 * Paths that held no install, as given. A link to a launcher, e.g. /usr/local/bin/rider, fails the install layout
+	 * checks its target passes, so a failure says nothing about other paths leading to the same file
+	 */
+	TSet<FString> FailedProbes;
+	int32 NumProbes = 0;
+};
+
+struct FDiscoverySource
+{
+	FName Name;
+	TFunction<TArray<FInstallInfo>(FDiscoveryContext&)> Collect;
+};
+
+struct FDiscoveryStats
+{
+	struct FSourceStats
+	{
+		FName Name;
+		double Seconds = 0.0;
+		int32 NumInstalls = 0;
+	};
+
+	TArray<FSourceStats> Sources;
+	double TotalSeconds = 0.0;
+	int32 NumProbes = 0;
+};
+
+struct FBudgetedDiscoveryResult
+{
+	/** Installs found before the time budget expired, all installs if discovery finished in time */
+	TSet<FInstallInfo> InstallInfos;
+
+	/** Full discovery result, only valid if the budget expired before all sources were done */
+	TFuture<TSet<FInstallInfo>> Remaining;
+
+	bool IsComplete() const { return !Remaining.IsValid(); }
 };
 
-template <typename OptionalType> struct TOptional;
 class FRiderPathLocator
 {
 public:
 	// Platform specific implementation
 	static TOptional<FInstallInfo> GetInstallInfoFromRiderPath(const FString& Path, FInstallInfo::EInstallType InstallType);
 	static bool DirectoryExistsAndNonEmpty(const FString& Path);
-	static TSet<FInstallInfo> CollectAllPaths();
+	static TSet<FInstallInfo> CollectAllPaths(FDiscoveryStats* OutStats = nullptr);
+
+	/** The plugin's list of custom install locations, empty if the plugin can't be found */
+	static FString GetResourceLocationsFile();
+
+	/** Runs discovery on a worker thread and waits for it at most TimeBudgetSeconds */
+	static FBudgetedDiscoveryResult CollectAllPathsWithinBudget(double TimeBudgetSeconds);
 private:
+	/**
+	 * OnSourceCollected gets each source's installs with the source's index in GetDiscoverySources.
+	 * bSaveSourceYields stores how many installs each source found, which orders the sources of later runs
+	 */
+	static TSet<FInstallInfo> CollectAllPaths(FDiscoveryStats* OutStats, bool bSaveSourceYields, TFunctionRef<void(int32, const TArray<FInstallInfo>&)> OnSourceCollected);
+
+	/** Installs of the sources by index in GetDiscoverySources, merged in that order whichever order they ran in */
+	static TSet<FInstallInfo> MergeInSourceOrder(const TMap<int32, TArray<FInstallInfo>>& SourceInstallInfos);
+
+	friend class FDiscoveryContext;
+	friend class FRiderPathLocatorBenchmark;
+
+	// Platform specific implementation, resolves symlinks so different routes to one install compare equal
+	static FString GetCanonicalPath(const FString& Path);
+
+	// Platform specific implementation
+	static TArray<FDiscoverySource> GetDiscoverySources();
 	static void ParseProductInfoJson(FInstallInfo& Info, const FString& ProductInfoJsonPath);
 	static FString GetDefaultIDEInstallLocationForToolboxV2();
-	static TArray<FInstallInfo> GetInstallInfosFromToolbox(const FString& ToolboxPath, const FString& Pattern);
-	static TArray<FInstallInfo> GetInstallInfosFromResourceFile();
-	static TArray<FInstallInfo> GetInstallInfos(const FString& ToolboxRiderRootPath, const FString& Pattern, FInstallInfo::EInstallType InstallType);
+	static TArray<FInstallInfo> GetInstallInfosFromToolbox(FDiscoveryContext& Context, const FString& ToolboxPath, const FString& Pattern);
+
+	/** Installs listed in the Toolbox App's state.json, unset if it is missing or doesn't match what is on disk */
+	static TOptional<TArray<FInstallInfo>> GetInstallInfosFromToolboxState(FDiscoveryContext& Context, const FString& ToolboxPath);
+	static TArray<FInstallInfo> GetInstallInfosFromResourceFile(FDiscoveryContext& Context);
+	static TArray<FInstallInfo> GetInstallInfosFromLocationsFile(FDiscoveryContext& Context, const FString& RiderLocationsFile);
+	static TArray<FInstallInfo> GetInstallInfos(FDiscoveryContext& Context, const FString& ToolboxRiderRootPath, const FString& Pattern, FInstallInfo::EInstallType InstallType);
 	static FString GetHistoryJsonPath(const FString& RiderPath);
 	static FVersion GetLastBuildVersion(const FString& HistoryJsonPath);
 };
@@ -110,7 +110,7 @@ static LONG GetStringRegKey(const HKEY Key, const FString& ValueName, FString& V
 	}
 	return Result;
 }
-static TArray<FInstallInfo> CollectPathsFromRegistry( const Windows::HKEY RootKey, const FString& RegistryKey)
+static TArray<FInstallInfo> CollectPathsFromRegistry(FDiscoveryContext& Context, const Windows::HKEY RootKey, const FString& RegistryKey)
 {
 	TArray<FInstallInfo> InstallInfos;
 	HKEY Key;
@@ -138,7 +138,7 @@ static TArray<FInstallInfo> CollectPathsFromRegistry( const Windows::HKEY RootKe
 			if (GetStringRegKey(SubKey, Value, InstallLocation) != ERROR_SUCCESS) continue;
 			
 			const FString ExePath = FPaths::Combine(InstallLocation, TEXT("bin"), TEXT("rider64.exe"));
-			TOptional<FInstallInfo> InstallInfo = FRiderPathLocator::GetInstallInfoFromRiderPath(ExePath, FInstallInfo::EInstallType::Installed);
+			TOptional<FInstallInfo> InstallInfo = Context.Probe(ExePath, FInstallInfo::EInstallType::Installed);
 			if(InstallInfo.IsSet())
 			{
 				InstallInfos.Add(InstallInfo.GetValue());
@@ -149,7 +149,7 @@ static TArray<FInstallInfo> CollectPathsFromRegistry( const Windows::HKEY RootKe
 	return InstallInfos;
 }
 
-static TArray<FInstallInfo> CollectDotUltimatePathsFromRegistry( const Windows::HKEY RootKey, const FString& RegistryKey)
+static TArray<FInstallInfo> CollectDotUltimatePathsFromRegistry(FDiscoveryContext& Context, const Windows::HKEY RootKey, const FString& RegistryKey)
 {
 	TArray<FInstallInfo> InstallInfos;
 	HKEY Key;
@@ -176,7 +176,7 @@ static TArray<FInstallInfo> CollectDotUltimatePathsFromRegistry( const Windows::
 			if (GetStringRegKey(SubKey, Value, InstallLocation) != ERROR_SUCCESS) continue;
 			
 			const FString ExePath = FPaths::Combine(InstallLocation, TEXT("bin"), TEXT("rider64.exe"));
-			TOptional<FInstallInfo> InstallInfo = FRiderPathLocator::GetInstallInfoFromRiderPath(ExePath, FInstallInfo::EInstallType::Installed);
+			TOptional<FInstallInfo> InstallInfo = Context.Probe(ExePath, FInstallInfo::EInstallType::Installed);
 			if(InstallInfo.IsSet())
 			{
 				InstallInfos.Add(InstallInfo.GetValue());
@@ -187,6 +187,14 @@ static TArray<FInstallInfo> CollectDotUltimatePathsFromRegistry( const Windows::
 	return InstallInfos;
 }
 
+FString FRiderPathLocator::GetCanonicalPath(const FString& Path)
+{
+	// NTFS is case-insensitive, so fold the case once here instead of comparing case-insensitively everywhere
+	FString CanonicalPath = FPaths::ConvertRelativePathToFull(Path);
+	FPaths::NormalizeFilename(CanonicalPath);
+	return CanonicalPath.ToLower();
+}
+
 TOptional<FInstallInfo> FRiderPathLocator::GetInstallInfoFromRiderPath(const FString& Path, FInstallInfo::EInstallType InstallType)
 {
 	if(!FPaths::FileExists(Path))
@@ -209,9 +217,7 @@ TOptional<FInstallInfo> FRiderPathLocator::GetInstallInfoFromRiderPath(const FSt
 		return {};
 	}
 	
-	FInstallInfo Info;
-	Info.Path = Path;
-	Info.InstallType = InstallType;
+	FInstallInfo Info(Path, InstallType);
 	const FString ProductInfoJsonPath = FPaths::Combine(RiderDir, TEXT("product-info.json"));
 	if (FPaths::FileExists(ProductInfoJsonPath))
 	{
@@ -228,23 +234,23 @@ TOptional<FInstallInfo> FRiderPathLocator::GetInstallInfoFromRiderPath(const FSt
 	return Info;
 }
 
-TSet<FInstallInfo> FRiderPathLocator::CollectAllPaths()
+TArray<FDiscoverySource> FRiderPathLocator::GetDiscoverySources()
 {
-	TSet<FInstallInfo> InstallInfos;
-	InstallInfos.Append(CollectPathsFromRegistry(HKEY_CURRENT_USER, TEXT("SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall")));
-	InstallInfos.Append(CollectPathsFromRegistry(HKEY_LOCAL_MACHINE, TEXT("SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall")));
-	InstallInfos.Append(CollectPathsFromRegistry(HKEY_CURRENT_USER, TEXT("SOFTWARE\\WOW6432Node\\Microsoft\\Windows\\CurrentVersion\\Uninstall")));
-	InstallInfos.Append(CollectPathsFromRegistry(HKEY_LOCAL_MACHINE, TEXT("SOFTWARE\\WOW6432Node\\Microsoft\\Windows\\CurrentVersion\\Uninstall")));
-	InstallInfos.Append(CollectDotUltimatePathsFromRegistry(HKEY_CURRENT_USER, TEXT("SOFTWARE\\JetBrains\\Rider")));
-	InstallInfos.Append(CollectDotUltimatePathsFromRegistry(HKEY_LOCAL_MACHINE, TEXT("SOFTWARE\\JetBrains\\Rider")));
-	InstallInfos.Append(CollectDotUltimatePathsFromRegistry(HKEY_CURRENT_USER, TEXT("SOFTWARE\\WOW6432Node\\JetBrains\\Rider")));
-	InstallInfos.Append(CollectDotUltimatePathsFromRegistry(HKEY_LOCAL_MACHINE, TEXT("SOFTWARE\\WOW6432Node\\JetBrains\\Rider")));
-	InstallInfos.Append(GetInstallInfosFromToolbox(GetToolboxPath(), "rider64.exe"));
-	InstallInfos.Append(GetInstallInfosFromToolbox(GetToolboxPath(HKEY_CURRENT_USER, TEXT("Software\\JetBrains\\Toolbox\\")), "rider64.exe"));
-	InstallInfos.Append(GetInstallInfosFromToolbox(GetToolboxPath(HKEY_LOCAL_MACHINE, TEXT("Software\\JetBrains\\Toolbox\\")), "rider64.exe"));
-	InstallInfos.Append(GetInstallInfosFromToolbox(GetToolboxPath(HKEY_CURRENT_USER, TEXT("Software\\JetBrains s.r.o.\\JetBrainsToolbox\\")), "rider64.exe"));
-	InstallInfos.Append(GetInstallInfosFromToolbox(GetToolboxPath(HKEY_LOCAL_MACHINE, TEXT("Software\\JetBrains s.r.o.\\JetBrainsToolbox\\")), "rider64.exe"));
-	InstallInfos.Append(GetInstallInfosFromResourceFile());
-	return InstallInfos;
+	return {
+		{ TEXT("Registry.HKCU.Uninstall"), [](FDiscoveryContext& Context) { return CollectPathsFromRegistry(Context, HKEY_CURRENT_USER, TEXT("SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall")); } },
+		{ TEXT("Registry.HKLM.Uninstall"), [](FDiscoveryContext& Context) { return CollectPathsFromRegistry(Context, HKEY_LOCAL_MACHINE, TEXT("SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall")); } },
+		{ TEXT("Registry.HKCU.WOW6432Uninstall"), [](FDiscoveryContext& Context) { return CollectPathsFromRegistry(Context, HKEY_CURRENT_USER, TEXT("SOFTWARE\\WOW6432Node\\Microsoft\\Windows\\CurrentVersion\\Uninstall")); } },
+		{ TEXT("Registry.HKLM.WOW6432Uninstall"), [](FDiscoveryContext& Context) { return CollectPathsFromRegistry(Context, HKEY_LOCAL_MACHINE, TEXT("SOFTWARE\\WOW6432Node\\Microsoft\\Windows\\CurrentVersion\\Uninstall")); } },
+		{ TEXT("Registry.HKCU.DotUltimate"), [](FDiscoveryContext& Context) { return CollectDotUltimatePathsFromRegistry(Context, HKEY_CURRENT_USER, TEXT("SOFTWARE\\JetBrains\\Rider")); } },
+		{ TEXT("Registry.HKLM.DotUltimate"), [](FDiscoveryContext& Context) { return CollectDotUltimatePathsFromRegistry(Context, HKEY_LOCAL_MACHINE, TEXT("SOFTWARE\\JetBrains\\Rider")); } },
+		{ TEXT("Registry.HKCU.WOW6432DotUltimate"), [](FDiscoveryContext& Context) { return CollectDotUltimatePathsFromRegistry(Context, HKEY_CURRENT_USER, TEXT("SOFTWARE\\WOW6432Node\\JetBrains\\Rider")); } },
+		{ TEXT("Registry.HKLM.WOW6432DotUltimate"), [](FDiscoveryContext& Context) { return CollectDotUltimatePathsFromRegistry(Context, HKEY_LOCAL_MACHINE, TEXT("SOFTWARE\\WOW6432Node\\JetBrains\\Rider")); } },
+		{ TEXT("Toolbox"), [](FDiscoveryContext& Context) { return GetInstallInfosFromToolbox(Context, GetToolboxPath(), "rider64.exe"); } },
+		{ TEXT("Toolbox.HKCU"), [](FDiscoveryContext& Context) { return GetInstallInfosFromToolbox(Context, GetToolboxPath(HKEY_CURRENT_USER, TEXT("Software\\JetBrains\\Toolbox\\")), "rider64.exe"); } },
+		{ TEXT("Toolbox.HKLM"), [](FDiscoveryContext& Context) { return GetInstallInfosFromToolbox(Context, GetToolboxPath(HKEY_LOCAL_MACHINE, TEXT("Software\\JetBrains\\Toolbox\\")), "rider64.exe"); } },
+		{ TEXT("ToolboxApp.HKCU"), [](FDiscoveryContext& Context) { return GetInstallInfosFromToolbox(Context, GetToolboxPath(HKEY_CURRENT_USER, TEXT("Software\\JetBrains s.r.o.\\JetBrainsToolbox\\")), "rider64.exe"); } },
+		{ TEXT("ToolboxApp.HKLM"), [](FDiscoveryContext& Context) { return GetInstallInfosFromToolbox(Context, GetToolboxPath(HKEY_LOCAL_MACHINE, TEXT("Software\\JetBrains s.r.o.\\JetBrainsToolbox\\")), "rider64.exe"); } },
+		{ TEXT("ResourceFile"), [](FDiscoveryContext& Context) { return GetInstallInfosFromResourceFile(Context); } }
+	};
 }
 #endif
\ No newline at end of file
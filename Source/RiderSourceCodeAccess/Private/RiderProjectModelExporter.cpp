@@ -0,0 +1,386 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderProjectModelExporter.h"
+
+#include "RiderSourceTree.h"
+
+#include "Async/Async.h"
+#include "DesktopPlatformModule.h"
+#include "DirectoryWatcherModule.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/OutputDeviceNull.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Modules/ModuleManager.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+#if WITH_LIVE_CODING
+#include "ILiveCodingModule.h"
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogRiderProjectModel, Log, All);
+
+static TUniquePtr<FRiderProjectModelExporter> ProjectModelExporter;
+
+void FRiderProjectModelExporter::Initialize(TFunction<bool()> IsUprojectModelSelected)
+{
+	if (ProjectModelExporter.IsValid() || !FPaths::IsProjectFilePathSet()) return;
+
+	ProjectModelExporter = MakeUnique<FRiderProjectModelExporter>();
+	ProjectModelExporter->IsUprojectModelSelected = MoveTemp(IsUprojectModelSelected);
+	ProjectModelExporter->TickerHandle = FRiderTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(ProjectModelExporter.Get(), &FRiderProjectModelExporter::Tick), 1.0f);
+	ProjectModelExporter->RegisterProjectDirWatch();
+	FRiderSourceTreeWatcher::Initialize();
+	if (FRiderSourceTreeWatcher* Watcher = FRiderSourceTreeWatcher::Get())
+	{
+		ProjectModelExporter->FilesChangedHandle = Watcher->OnFilesChanged().AddRaw(ProjectModelExporter.Get(), &FRiderProjectModelExporter::HandleFilesChanged);
+	}
+}
+
+void FRiderProjectModelExporter::Shutdown()
+{
+	ProjectModelExporter.Reset();
+}
+
+FString FRiderProjectModelExporter::GetTargetExportPath()
+{
+	return FPaths::Combine(FPaths::ConvertRelativePathToFull(FPaths::ProjectIntermediateDir()), TEXT("Rider"), TEXT("TargetExport.json"));
+}
+
+FString FRiderProjectModelExporter::GetModelPath()
+{
+	return FPaths::Combine(FPaths::ConvertRelativePathToFull(FPaths::ProjectIntermediateDir()), TEXT("Rider"), TEXT("ProjectModel.json"));
+}
+
+FRiderProjectModelExporter::~FRiderProjectModelExporter()
+{
+	FRiderTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	UnregisterProjectDirWatch();
+	if (FRiderSourceTreeWatcher* Watcher = FRiderSourceTreeWatcher::Get())
+	{
+		Watcher->OnFilesChanged().Remove(FilesChangedHandle);
+	}
+	if (ExportTask.IsValid())
+	{
+		ExportTask.Wait();
+	}
+}
+
+bool FRiderProjectModelExporter::Tick(float DeltaTime)
+{
+	if (!bDirty || (ExportTask.IsValid() && !ExportTask.IsReady()) || FPlatformTime::Seconds() < NextExportTime) return true;
+
+	// Checked on every tick, so switching the accessor to the Uproject model exports right away
+	if (!IsUprojectModelSelected()) return true;
+
+	// The export would queue for UnrealBuildTool's mutex behind the build, and hold up the next one
+	if (IsBuildRunning())
+	{
+		NextExportTime = FPlatformTime::Seconds() + BuildRetrySeconds;
+		return true;
+	}
+
+	bDirty = false;
+	StartExport();
+	return true;
+}
+
+void FRiderProjectModelExporter::HandleFilesChanged(const TArray<FFileChangeData>& Changes)
+{
+	for (const FFileChangeData& Change : Changes)
+	{
+		if (Change.Filename.EndsWith(TEXT(".Build.cs")) || Change.Filename.EndsWith(TEXT(".Target.cs")) || Change.Filename.EndsWith(TEXT(".uplugin")) || Change.Filename.EndsWith(TEXT(".uproject")))
+		{
+			bDirty = true;
+			return;
+		}
+	}
+}
+
+void FRiderProjectModelExporter::RegisterProjectDirWatch()
+{
+	IDirectoryWatcher* DirectoryWatcher = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")).Get();
+	if (DirectoryWatcher == nullptr) return;
+
+	// The .uproject sits above the watched source trees, its own directory is watched without the subtree
+	DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(FPaths::ConvertRelativePathToFull(FPaths::ProjectDir()),
+		IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FRiderProjectModelExporter::HandleFilesChanged), ProjectDirWatchHandle,
+		IDirectoryWatcher::WatchOptions::IgnoreChangesInSubtree);
+}
+
+void FRiderProjectModelExporter::UnregisterProjectDirWatch()
+{
+	FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule != nullptr ? DirectoryWatcherModule->Get() : nullptr;
+	if (DirectoryWatcher != nullptr && ProjectDirWatchHandle.IsValid())
+	{
+		DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(FPaths::ConvertRelativePathToFull(FPaths::ProjectDir()), ProjectDirWatchHandle);
+	}
+	ProjectDirWatchHandle.Reset();
+}
+
+void FRiderProjectModelExporter::StartExport()
+{
+	FExportInputs Inputs;
+	Inputs.DesktopPlatform = FDesktopPlatformModule::Get();
+	Inputs.ProjectFile = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+	Inputs.TargetName = GetTargetName();
+	Inputs.Platform = FPlatformMisc::GetUBTPlatform();
+	Inputs.Configuration = LexToString(FApp::GetBuildConfiguration());
+	Inputs.InputFiles.Add(Inputs.ProjectFile);
+	for (const TSharedRef<IPlugin>& Plugin : IPluginManager::Get().GetEnabledPlugins())
+	{
+		Inputs.InputFiles.Add(FPaths::ConvertRelativePathToFull(Plugin->GetDescriptorFileName()));
+		Inputs.PluginDirs.Add(FPaths::ConvertRelativePathToFull(Plugin->GetBaseDir()), Plugin->GetName());
+	}
+
+	const FString SourceDir = FPaths::ConvertRelativePathToFull(FPaths::GameSourceDir());
+	TArray<FString> TargetFiles;
+	IFileManager::Get().FindFiles(TargetFiles, *FPaths::Combine(SourceDir, TEXT("*.Target.cs")), true, false);
+	for (const FString& TargetFile : TargetFiles)
+	{
+		Inputs.InputFiles.Add(FPaths::Combine(SourceDir, TargetFile));
+	}
+
+	// UnrealBuildTool takes seconds, so the export gets a thread of its own instead of blocking a pool worker
+	ExportTask = Async(EAsyncExecution::Thread, [Inputs = MoveTemp(Inputs)]()
+	{
+		Export(Inputs);
+	});
+}
+
+bool FRiderProjectModelExporter::IsBuildRunning()
+{
+#if WITH_LIVE_CODING
+	ILiveCodingModule* LiveCoding = FModuleManager::GetModulePtr<ILiveCodingModule>(LIVE_CODING_MODULE_NAME);
+	if (LiveCoding != nullptr && LiveCoding->IsCompiling()) return true;
+#endif
+
+	// UnrealBuildTool runs as its own executable on Windows, elsewhere in the .NET or Mono runtime bundled with the engine
+	FString EngineBinariesDir = FPaths::ConvertRelativePathToFull(FPaths::EngineDir() / TEXT("Binaries") / TEXT("ThirdParty"));
+	FPaths::NormalizeDirectoryName(EngineBinariesDir);
+	const FString RuntimeDirs[] = { EngineBinariesDir + TEXT("/DotNet/"), EngineBinariesDir + TEXT("/Mono/") };
+
+	FPlatformProcess::FProcEnumerator ProcEnumerator;
+	while (ProcEnumerator.MoveNext())
+	{
+		const FPlatformProcess::FProcEnumInfo ProcInfo = ProcEnumerator.GetCurrent();
+		if (ProcInfo.GetName().StartsWith(TEXT("UnrealBuildTool"))) return true;
+
+		FString FullPath = ProcInfo.GetFullPath();
+		FPaths::NormalizeFilename(FullPath);
+		for (const FString& RuntimeDir : RuntimeDirs)
+		{
+			if (FullPath.StartsWith(RuntimeDir)) return true;
+		}
+	}
+	return false;
+}
+
+FString FRiderProjectModelExporter::GetTargetName()
+{
+	// {"Targets": [{"Name": "MyGameEditor", "Path": ".../MyGameEditor.Target.cs", "Type": "Editor"}, ...]}
+	const TSharedPtr<FJsonObject> TargetInfo = ReadJsonFile(FPaths::Combine(FPaths::ProjectIntermediateDir(), TEXT("TargetInfo.json")));
+	const TArray<TSharedPtr<FJsonValue>>* Targets = nullptr;
+	if (TargetInfo.IsValid() && TargetInfo->TryGetArrayField(TEXT("Targets"), Targets))
+	{
+		for (const TSharedPtr<FJsonValue>& Target : *Targets)
+		{
+			const TSharedPtr<FJsonObject>* TargetObject = nullptr;
+			FString Name;
+			FString Type;
+			if (Target->TryGetObject(TargetObject) && (*TargetObject)->TryGetStringField(TEXT("Name"), Name)
+				&& (*TargetObject)->TryGetStringField(TEXT("Type"), Type) && Type == TEXT("Editor"))
+			{
+				return Name;
+			}
+		}
+	}
+	return FString(FApp::GetProjectName()) + TEXT("Editor");
+}
+
+TSharedPtr<FJsonObject> FRiderProjectModelExporter::ReadJsonFile(const FString& Path)
+{
+	FString Json;
+	if (!FFileHelper::LoadFileToString(Json, *Path, FFileHelper::EHashOptions::None, FILEREAD_Silent)) return {};
+
+	TSharedPtr<FJsonObject> JsonObject;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject)) return {};
+	return JsonObject;
+}
+
+TArray<FString> FRiderProjectModelExporter::GetBuildFiles(const TSharedPtr<FJsonObject>& TargetExport)
+{
+	TArray<FString> Result;
+	const TSharedPtr<FJsonObject>* Modules = nullptr;
+	if (!TargetExport.IsValid() || !TargetExport->TryGetObjectField(TEXT("Modules"), Modules)) return Result;
+
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Module : (*Modules)->Values)
+	{
+		const TSharedPtr<FJsonObject>* ModuleObject = nullptr;
+		FString BuildFile;
+		if (Module.Value->TryGetObject(ModuleObject) && (*ModuleObject)->TryGetStringField(TEXT("Rules"), BuildFile))
+		{
+			Result.Add(BuildFile);
+		}
+	}
+	Result.Sort();
+	return Result;
+}
+
+FString FRiderProjectModelExporter::GetInputsHash(const FExportInputs& Inputs, const TArray<FString>& BuildFiles)
+{
+	FString InputsString = FString::Printf(TEXT("%d|%s|%s|%s|%s"), FormatVersion, *FEngineVersion::Current().ToString(), *Inputs.TargetName, *Inputs.Platform, *Inputs.Configuration);
+	const auto AddFile = [&InputsString](const FString& Path)
+	{
+		InputsString += FString::Printf(TEXT("|%s@%lld"), *Path, IFileManager::Get().GetTimeStamp(*Path).GetTicks());
+	};
+	for (const FString& InputFile : Inputs.InputFiles)
+	{
+		AddFile(InputFile);
+	}
+	for (const FString& BuildFile : BuildFiles)
+	{
+		AddFile(BuildFile);
+	}
+	return FMD5::HashAnsiString(*InputsString);
+}
+
+FString FRiderProjectModelExporter::ReadInputsHash()
+{
+	const TSharedPtr<FJsonObject> Model = ReadJsonFile(GetModelPath());
+	FString InputsHash;
+	if (Model.IsValid())
+	{
+		Model->TryGetStringField(TEXT("inputsHash"), InputsHash);
+	}
+	return InputsHash;
+}
+
+bool FRiderProjectModelExporter::RunTargetExport(const FExportInputs& Inputs)
+{
+	if (Inputs.DesktopPlatform == nullptr) return false;
+
+	const FString CommandLine = FString::Printf(TEXT("%s %s %s -Project=\"%s\" -Mode=JsonExport -OutputFile=\"%s\""),
+		*Inputs.TargetName, *Inputs.Platform, *Inputs.Configuration, *Inputs.ProjectFile, *GetTargetExportPath());
+	FOutputDeviceNull OutputDevice;
+	int32 ReturnCode = 0;
+	FString Output;
+	if (!Inputs.DesktopPlatform->InvokeUnrealBuildToolSync(CommandLine, OutputDevice, true, ReturnCode, Output) || ReturnCode != 0)
+	{
+		UE_LOG(LogRiderProjectModel, Warning, TEXT("UnrealBuildTool couldn't export %s (exit code %d): %s"), *Inputs.TargetName, ReturnCode, *Output);
+		return false;
+	}
+	return true;
+}
+
+void FRiderProjectModelExporter::Export(const FExportInputs& Inputs)
+{
+	// Build files are only known from an export, the descriptors listing the modules cover added and removed ones
+	TSharedPtr<FJsonObject> TargetExport = ReadJsonFile(GetTargetExportPath());
+	if (GetInputsHash(Inputs, GetBuildFiles(TargetExport)) == ReadInputsHash())
+	{
+		UE_LOG(LogRiderProjectModel, Verbose, TEXT("Project model is up to date"));
+		return;
+	}
+
+	if (!RunTargetExport(Inputs)) return;
+
+	TargetExport = ReadJsonFile(GetTargetExportPath());
+	if (!TargetExport.IsValid())
+	{
+		UE_LOG(LogRiderProjectModel, Warning, TEXT("Couldn't read UnrealBuildTool's export %s"), *GetTargetExportPath());
+		return;
+	}
+	WriteModel(Inputs, TargetExport, GetInputsHash(Inputs, GetBuildFiles(TargetExport)));
+}
+
+bool FRiderProjectModelExporter::WriteModel(const FExportInputs& Inputs, const TSharedPtr<FJsonObject>& TargetExport, const FString& InputsHash)
+{
+	const TSharedPtr<FJsonObject>* Modules = nullptr;
+	if (!TargetExport->TryGetObjectField(TEXT("Modules"), Modules)) return false;
+
+	const auto WriteStrings = [](const TSharedRef<TJsonWriter<>>& Writer, const TCHAR* Name, const TSharedPtr<FJsonObject>& Module, TArrayView<const TCHAR* const> Fields)
+	{
+		Writer->WriteArrayStart(Name);
+		for (const TCHAR* Field : Fields)
+		{
+			TArray<FString> Values;
+			if (Module->TryGetStringArrayField(Field, Values))
+			{
+				for (const FString& Value : Values)
+				{
+					Writer->WriteValue(Value);
+				}
+			}
+		}
+		Writer->WriteArrayEnd();
+	};
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("version"), FormatVersion);
+	Writer->WriteValue(TEXT("inputsHash"), InputsHash);
+	Writer->WriteValue(TEXT("engineVersion"), FEngineVersion::Current().ToString());
+	Writer->WriteValue(TEXT("engineDir"), FPaths::ConvertRelativePathToFull(FPaths::EngineDir()));
+	Writer->WriteValue(TEXT("project"), Inputs.ProjectFile);
+	Writer->WriteObjectStart(TEXT("target"));
+	Writer->WriteValue(TEXT("name"), Inputs.TargetName);
+	Writer->WriteValue(TEXT("platform"), Inputs.Platform);
+	Writer->WriteValue(TEXT("configuration"), Inputs.Configuration);
+	Writer->WriteObjectEnd();
+	Writer->WriteArrayStart(TEXT("modules"));
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Module : (*Modules)->Values)
+	{
+		const TSharedPtr<FJsonObject>* ModuleObject = nullptr;
+		if (!Module.Value->TryGetObject(ModuleObject)) continue;
+
+		FString Dir;
+		FString BuildFile;
+		(*ModuleObject)->TryGetStringField(TEXT("Directory"), Dir);
+		(*ModuleObject)->TryGetStringField(TEXT("Rules"), BuildFile);
+		FString Plugin;
+		for (const TPair<FString, FString>& PluginDir : Inputs.PluginDirs)
+		{
+			if (FPaths::IsUnderDirectory(Dir, PluginDir.Key))
+			{
+				Plugin = PluginDir.Value;
+				break;
+			}
+		}
+
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("name"), Module.Key);
+		Writer->WriteValue(TEXT("plugin"), Plugin);
+		Writer->WriteValue(TEXT("dir"), Dir);
+		Writer->WriteValue(TEXT("buildFile"), BuildFile);
+		WriteStrings(Writer, TEXT("includeDirs"), *ModuleObject, { TEXT("PublicIncludePaths"), TEXT("PublicSystemIncludePaths"), TEXT("PrivateIncludePaths") });
+		WriteStrings(Writer, TEXT("defines"), *ModuleObject, { TEXT("PublicDefinitions"), TEXT("PrivateDefinitions") });
+		WriteStrings(Writer, TEXT("dependencies"), *ModuleObject, { TEXT("PublicDependencyModules"), TEXT("PrivateDependencyModules") });
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	const FString ModelPath = GetModelPath();
+	const FString TempPath = ModelPath + TEXT(".tmp");
+	if (!FFileHelper::SaveStringToFile(Json, *TempPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM) || !IFileManager::Get().Move(*ModelPath, *TempPath))
+	{
+		UE_LOG(LogRiderProjectModel, Warning, TEXT("Failed to write %s"), *ModelPath);
+		return false;
+	}
+	UE_LOG(LogRiderProjectModel, Log, TEXT("Exported %d modules of %s to %s"), (*Modules)->Values.Num(), *Inputs.TargetName, *ModelPath);
+	return true;
+}
@@ -0,0 +1,86 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "IDirectoryWatcher.h"
+#include "RiderTicker.h"
+
+class FJsonObject;
+class IDesktopPlatform;
+
+/**
+ * Writes the modules of the editor target, with their build files, include directories, definitions and dependencies,
+ * to <Project>/Intermediate/Rider/ProjectModel.json, so Rider can load a .uproject without running UnrealBuildTool itself.
+ * The modules come from UnrealBuildTool's JSON export of the target, which runs in the background only when the hash of
+ * the project and plugin descriptors, target files and module build files it was made from changes.
+ * Opt-in with bExportProjectModel, started by editors with eager discovery only and skipped while a build is running.
+ */
+class FRiderProjectModelExporter
+{
+public:
+	/** Bump when the file layout changes so the IDE can ignore files it doesn't understand */
+	static const int32 FormatVersion = 2;
+
+	/**
+	 * Must be called on the game thread, the first export runs on the first tick after startup.
+	 * IsUprojectModelSelected is asked before every export, other project models don't read the file
+	 */
+	static void Initialize(TFunction<bool()> IsUprojectModelSelected);
+	static void Shutdown();
+
+	static FString GetModelPath();
+
+	~FRiderProjectModelExporter();
+
+private:
+	/** Everything the export needs from the game thread */
+	struct FExportInputs
+	{
+		IDesktopPlatform* DesktopPlatform = nullptr;
+		FString ProjectFile;
+		FString TargetName;
+		FString Platform;
+		FString Configuration;
+
+		/** Project and plugin descriptors and target files, module build files come from the last export */
+		TArray<FString> InputFiles;
+
+		/** Plugin names by base directory, to tell which plugin a module belongs to */
+		TMap<FString, FString> PluginDirs;
+	};
+
+	/** A build waiting for the UnrealBuildTool mutex is retried after this long */
+	static constexpr double BuildRetrySeconds = 10.0;
+
+	bool Tick(float DeltaTime);
+	void HandleFilesChanged(const TArray<FFileChangeData>& Changes);
+	void RegisterProjectDirWatch();
+	void UnregisterProjectDirWatch();
+
+	/** Gathers the inputs on the game thread, hashing, UnrealBuildTool and writing run on a background thread */
+	void StartExport();
+
+	/** The editor target listed in UnrealBuildTool's TargetInfo.json, <Project>Editor if it wasn't written yet */
+	static FString GetTargetName();
+
+	/** Live Coding compiling, or UnrealBuildTool running for a build the export would have to wait for */
+	static bool IsBuildRunning();
+	static FString GetTargetExportPath();
+	static TSharedPtr<FJsonObject> ReadJsonFile(const FString& Path);
+	static TArray<FString> GetBuildFiles(const TSharedPtr<FJsonObject>& TargetExport);
+	static FString GetInputsHash(const FExportInputs& Inputs, const TArray<FString>& BuildFiles);
+	static FString ReadInputsHash();
+	static bool RunTargetExport(const FExportInputs& Inputs);
+	static void Export(const FExportInputs& Inputs);
+	static bool WriteModel(const FExportInputs& Inputs, const TSharedPtr<FJsonObject>& TargetExport, const FString& InputsHash);
+
+	TFunction<bool()> IsUprojectModelSelected;
+	double NextExportTime = 0.0;
+	FRiderTickerHandle TickerHandle;
+	FDelegateHandle FilesChangedHandle;
+	FDelegateHandle ProjectDirWatchHandle;
+	TFuture<void> ExportTask;
+	bool bDirty = true;
+};
@@ -0,0 +1,300 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderRemoteTransport.h"
+
+#include "RiderSourceCodeAccessSettings.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/RunnableThread.h"
+#include "IPAddress.h"
+#include "Misc/ScopeLock.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRiderRemote, Log, All);
+
+static TUniquePtr<FRiderRemoteTransport> RemoteTransport;
+static TAtomic<bool> bSuspended { false };
+
+static const float MaxReconnectDelaySeconds = 10.0f;
+
+void FRiderRemoteTransport::Initialize()
+{
+	const FRiderSourceCodeAccessSettings Settings = FRiderSourceCodeAccessSettings::Get();
+	if (RemoteTransport.IsValid() || Settings.RemoteHost.IsEmpty()) return;
+
+	FString Host;
+	FString PortString;
+	if (!Settings.RemoteHost.Split(TEXT(":"), &Host, &PortString, ESearchCase::CaseSensitive, ESearchDir::FromEnd) || !PortString.IsNumeric())
+	{
+		UE_LOG(LogRiderRemote, Warning, TEXT("RemoteHost must be host:port, got '%s'"), *Settings.RemoteHost);
+		return;
+	}
+
+	TArray<TPair<FString, FString>> PathMap;
+	for (const FString& Mapping : Settings.RemotePathMap)
+	{
+		FString LocalPrefix;
+		FString RemotePrefix;
+		if (Mapping.Split(TEXT("|"), &LocalPrefix, &RemotePrefix))
+		{
+			PathMap.Emplace(LocalPrefix, RemotePrefix);
+		}
+	}
+	RemoteTransport = MakeUnique<FRiderRemoteTransport>(Host, FCString::Atoi(*PortString), PathMap);
+}
+
+void FRiderRemoteTransport::Shutdown()
+{
+	RemoteTransport.Reset();
+}
+
+FRiderRemoteTransport* FRiderRemoteTransport::Get()
+{
+	return bSuspended ? nullptr : RemoteTransport.Get();
+}
+
+void FRiderRemoteTransport::SetSuspended(bool bInSuspended)
+{
+	bSuspended = bInSuspended;
+}
+
+FRiderRemoteTransport::FRiderRemoteTransport(const FString& InHost, int32 InPort, const TArray<TPair<FString, FString>>& InPathMap)
+	: Host(InHost)
+	, Port(InPort)
+	, PathMap(InPathMap)
+{
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+	Thread = FRunnableThread::Create(this, TEXT("RiderRemoteTransport"), 0, TPri_BelowNormal);
+}
+
+FRiderRemoteTransport::~FRiderRemoteTransport()
+{
+	if (Thread != nullptr)
+	{
+		Thread->Kill(true);
+		delete Thread;
+	}
+	Disconnect();
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+}
+
+FString FRiderRemoteTransport::RemapPaths(const FString& Args) const
+{
+	FString Result;
+	Result.Reserve(Args.Len());
+	int32 Index = 0;
+	while (Index < Args.Len())
+	{
+		const int32 QuoteStart = Args.Find(TEXT("\""), ESearchCase::CaseSensitive, ESearchDir::FromStart, Index);
+		const int32 QuoteEnd = QuoteStart != INDEX_NONE ? Args.Find(TEXT("\""), ESearchCase::CaseSensitive, ESearchDir::FromStart, QuoteStart + 1) : INDEX_NONE;
+		if (QuoteEnd == INDEX_NONE)
+		{
+			Result += Args.Mid(Index);
+			break;
+		}
+
+		Result += Args.Mid(Index, QuoteStart + 1 - Index);
+		FString Argument = Args.Mid(QuoteStart + 1, QuoteEnd - QuoteStart - 1);
+		for (const TPair<FString, FString>& Mapping : PathMap)
+		{
+			// Only whole leading components, /work must not match /workspace
+			const int32 PrefixLen = Mapping.Key.Len();
+			const bool bAtBoundary = Argument.Len() == PrefixLen || Mapping.Key.EndsWith(TEXT("/")) || Mapping.Key.EndsWith(TEXT("\\"))
+				|| (Argument.Len() > PrefixLen && (Argument[PrefixLen] == TEXT('/') || Argument[PrefixLen] == TEXT('\\')));
+			if (Argument.StartsWith(Mapping.Key, ESearchCase::CaseSensitive) && bAtBoundary)
+			{
+				Argument = Mapping.Value + Argument.Mid(PrefixLen);
+				break;
+			}
+		}
+		Result += Argument + TEXT("\"");
+		Index = QuoteEnd + 1;
+	}
+	return Result;
+}
+
+bool FRiderRemoteTransport::Send(const FString& Args)
+{
+	if (!bReachable)
+	{
+		UE_LOG(LogRiderRemote, Warning, TEXT("Rider host %s can't be reached, not sending %s"), *GetHostName(), *Args);
+		return false;
+	}
+
+	{
+		FScopeLock Lock(&QueueCriticalSection);
+		if (Queue.Num() >= MaxQueuedRequests)
+		{
+			UE_LOG(LogRiderRemote, Verbose, TEXT("Request queue for %s is full, dropping the oldest request"), *GetHostName());
+			Queue.RemoveAt(0);
+		}
+
+		const int64 Id = NextId++;
+
+		FString Line;
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Line);
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("id"), Id);
+		Writer->WriteValue(TEXT("args"), RemapPaths(Args));
+		Writer->WriteObjectEnd();
+		Writer->Close();
+
+		Queue.Add({ Id, Line + TEXT("\n"), FPlatformTime::Seconds() });
+	}
+	WakeEvent->Trigger();
+	return true;
+}
+
+void FRiderRemoteTransport::Stop()
+{
+	bStopping = true;
+	WakeEvent->Trigger();
+}
+
+uint32 FRiderRemoteTransport::Run()
+{
+	while (!bStopping)
+	{
+		if (Socket == nullptr && !Connect())
+		{
+			WakeEvent->Wait(FTimespan::FromSeconds(ReconnectDelaySeconds));
+			ReconnectDelaySeconds = FMath::Min(ReconnectDelaySeconds * 2.0f, MaxReconnectDelaySeconds);
+			continue;
+		}
+
+		if (!SendPending() || !ReceiveAnswers())
+		{
+			Disconnect();
+			continue;
+		}
+
+		bool bIdle;
+		{
+			FScopeLock Lock(&QueueCriticalSection);
+			bIdle = Queue.Num() == 0 && InFlight.Num() == 0;
+		}
+		if (bIdle)
+		{
+			WakeEvent->Wait(FTimespan::FromMilliseconds(100));
+		}
+	}
+	return 0;
+}
+
+bool FRiderRemoteTransport::Connect()
+{
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	const FAddressInfoResult AddressInfo = SocketSubsystem->GetAddressInfo(*Host, *FString::FromInt(Port), EAddressInfoFlags::Default, NAME_None, ESocketType::SOCKTYPE_Streaming);
+	if (AddressInfo.ReturnCode != SE_NO_ERROR || AddressInfo.Results.Num() == 0)
+	{
+		UE_LOG(LogRiderRemote, Verbose, TEXT("Couldn't resolve %s"), *GetHostName());
+		bReachable = false;
+		return false;
+	}
+
+	const TSharedRef<FInternetAddr> Address = AddressInfo.Results[0].Address;
+	Socket = SocketSubsystem->CreateSocket(NAME_Stream, TEXT("RiderRemoteTransport"), Address->GetProtocolType());
+	if (Socket == nullptr) return false;
+
+	Socket->SetNoDelay(true);
+	if (!Socket->Connect(*Address))
+	{
+		UE_LOG(LogRiderRemote, Verbose, TEXT("Couldn't connect to %s"), *GetHostName());
+		Disconnect();
+		bReachable = false;
+		return false;
+	}
+
+	UE_LOG(LogRiderRemote, Log, TEXT("Connected to Rider host %s"), *GetHostName());
+	ReconnectDelaySeconds = 0.5f;
+	bReachable = true;
+	return true;
+}
+
+void FRiderRemoteTransport::Disconnect()
+{
+	if (Socket != nullptr)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+	ReceiveBuffer.Reset();
+
+	// Unanswered requests go first on the next connection, in their original order
+	if (InFlight.Num() > 0)
+	{
+		FScopeLock Lock(&QueueCriticalSection);
+		Queue.Insert(InFlight, 0);
+		InFlight.Reset();
+	}
+}
+
+bool FRiderRemoteTransport::SendPending()
+{
+	TArray<FRequest> Pending;
+	{
+		FScopeLock Lock(&QueueCriticalSection);
+		Pending = MoveTemp(Queue);
+		Queue.Reset();
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	const int32 NumPending = Pending.Num();
+	Pending.RemoveAll([Now](const FRequest& Request) { return Now - Request.QueuedTime > MaxRequestAgeSeconds; });
+	if (Pending.Num() < NumPending)
+	{
+		UE_LOG(LogRiderRemote, Log, TEXT("Dropped %d requests that waited more than %.0f s for %s"), NumPending - Pending.Num(), MaxRequestAgeSeconds, *GetHostName());
+	}
+
+	for (int32 Index = 0; Index < Pending.Num(); Index++)
+	{
+		const FTCHARToUTF8 Utf8Line(*Pending[Index].Line);
+		int32 Offset = 0;
+		while (Offset < Utf8Line.Length())
+		{
+			int32 BytesSent = 0;
+			if (!Socket->Send(reinterpret_cast<const uint8*>(Utf8Line.Get()) + Offset, Utf8Line.Length() - Offset, BytesSent) || BytesSent <= 0)
+			{
+				// The partly written request counts as in flight, it is resent whole after the reconnect
+				InFlight.Append(Pending.GetData() + Index, Pending.Num() - Index);
+				return false;
+			}
+			Offset += BytesSent;
+		}
+		InFlight.Add(MoveTemp(Pending[Index]));
+	}
+	return true;
+}
+
+bool FRiderRemoteTransport::ReceiveAnswers()
+{
+	if (InFlight.Num() == 0) return true;
+	if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(50))) return true;
+
+	uint8 Chunk[4096];
+	int32 BytesRead = 0;
+	if (!Socket->Recv(Chunk, sizeof(Chunk), BytesRead) || BytesRead <= 0) return false;
+	ReceiveBuffer.Append(Chunk, BytesRead);
+
+	// Answers come in request order, each line acknowledges the oldest request in flight
+	int32 LineStart = 0;
+	for (int32 Index = 0; Index < ReceiveBuffer.Num(); Index++)
+	{
+		if (ReceiveBuffer[Index] != '\n') continue;
+
+		LineStart = Index + 1;
+		if (InFlight.Num() > 0)
+		{
+			InFlight.RemoveAt(0);
+			++NumAcknowledged;
+		}
+	}
+	ReceiveBuffer.RemoveAt(0, LineStart);
+	return true;
+}
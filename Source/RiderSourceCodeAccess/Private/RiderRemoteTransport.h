@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Templates/Atomic.h"
+
+class FEvent;
+class FRunnableThread;
+class FSocket;
+
+/**
+ * Forwards launcher arguments to a Rider host over TCP, for editors running on machines without a display.
+ * Each request is one line of JSON, {"id":N,"args":"<launcher arguments>"}, and the host answers every request with one
+ * line in the order received. Requests are written without waiting for earlier answers. Unanswered requests are sent
+ * again after a reconnect, so the host may see a request twice. Requests that waited longer than MaxRequestAgeSeconds
+ * for a connection are dropped, an IDE jumping to a file the user asked for minutes ago is worse than not jumping.
+ */
+class FRiderRemoteTransport : public FRunnable
+{
+public:
+	/** Creates the transport from the RemoteHost setting, does nothing if it is empty */
+	static void Initialize();
+	static void Shutdown();
+
+	/** Null unless RemoteHost is configured, or while suspended */
+	static FRiderRemoteTransport* Get();
+
+	/** Opens go to local launchers while suspended, queued requests are kept for afterwards */
+	static void SetSuspended(bool bInSuspended);
+
+	FRiderRemoteTransport(const FString& InHost, int32 InPort, const TArray<TPair<FString, FString>>& InPathMap);
+	virtual ~FRiderRemoteTransport() override;
+
+	/**
+	 * Queues a request, paths in Args are remapped to the host's paths first.
+	 * False if the last connection attempt failed, true only means the request is queued, not that the host opened anything.
+	 */
+	bool Send(const FString& Args);
+
+	/** Replaces the local prefix of every quoted argument that starts with a mapped local path */
+	FString RemapPaths(const FString& Args) const;
+	FString GetHostName() const { return FString::Printf(TEXT("%s:%d"), *Host, Port); }
+
+	/** Requests the host has answered since the transport was created */
+	int32 GetNumAcknowledged() const { return NumAcknowledged; }
+
+	/** FRunnable implementation */
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	struct FRequest
+	{
+		int64 Id;
+		FString Line;
+		double QueuedTime;
+	};
+
+	static constexpr int32 MaxQueuedRequests = 64;
+	static constexpr double MaxRequestAgeSeconds = 30.0;
+
+	bool Connect();
+	void Disconnect();
+	bool SendPending();
+	bool ReceiveAnswers();
+
+	FString Host;
+	int32 Port;
+	TArray<TPair<FString, FString>> PathMap;
+
+	FCriticalSection QueueCriticalSection;
+	TArray<FRequest> Queue;
+	int64 NextId = 1;
+
+	/** Owned by the worker thread */
+	FSocket* Socket = nullptr;
+	TArray<FRequest> InFlight;
+	TArray<uint8> ReceiveBuffer;
+	float ReconnectDelaySeconds = 0.5f;
+
+	TAtomic<int32> NumAcknowledged { 0 };
+
+	/** Cleared while the host can't be reached, so opens fail instead of piling up */
+	TAtomic<bool> bReachable { true };
+	TAtomic<bool> bStopping { false };
+	FEvent* WakeEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+};
@@ -0,0 +1,140 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderRemoteTransport.h"
+
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "IPAddress.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRiderRemoteCheck, Log, All);
+
+/**
+ * Runs the remote transport against a loopback stand-in for a Rider host.
+ * Usage: Rider.Check.RemoteTransport [NumRequests=100]
+ * The stand-in drops the first connection halfway through, so the run covers pipelining, reconnecting and resending.
+ * Requests are paced to stay below the transport's queue cap, and carry a path that must only be remapped by prefix.
+ */
+class FRiderRemoteTransportCheck
+{
+public:
+	static bool Run(int32 NumRequests)
+	{
+		ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+		FSocket* Listener = SocketSubsystem->CreateSocket(NAME_Stream, TEXT("RiderRemoteStandIn"), false);
+		const TSharedRef<FInternetAddr> Address = SocketSubsystem->CreateInternetAddr();
+		Address->SetLoopbackAddress();
+		Address->SetPort(0);
+		if (Listener == nullptr || !Listener->Bind(*Address) || !Listener->Listen(1))
+		{
+			UE_LOG(LogRiderRemoteCheck, Error, TEXT("Couldn't start the stand-in host"));
+			if (Listener != nullptr) SocketSubsystem->DestroySocket(Listener);
+			return false;
+		}
+		Listener->GetAddress(*Address);
+
+		TFuture<FStandInResult> StandIn = Async(EAsyncExecution::Thread, [Listener, NumRequests]() { return Serve(Listener, NumRequests); });
+
+		const double StartTime = FPlatformTime::Seconds();
+		{
+			FRiderRemoteTransport Transport(TEXT("127.0.0.1"), Address->GetPort(), { TPair<FString, FString>(TEXT("/local/"), TEXT("/remote/")) });
+			for (int32 Index = 0; Index < NumRequests; Index++)
+			{
+				while (Index - Transport.GetNumAcknowledged() >= MaxUnansweredRequests && FPlatformTime::Seconds() - StartTime < 10.0)
+				{
+					FPlatformProcess::Sleep(0.001f);
+				}
+				Transport.Send(FString::Printf(TEXT("\"/local/Project.uproject\" --line %d \"/local/Source/File%d.cpp\" \"/mnt/local/Shared.h\""), Index, Index));
+			}
+			StandIn.Wait();
+		}
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+		SocketSubsystem->DestroySocket(Listener);
+
+		const FStandInResult Result = StandIn.Get();
+		const bool bPassed = Result.NumUnique == NumRequests && Result.bAllRemapped && Result.NumConnections > 1;
+		UE_LOG(LogRiderRemoteCheck, Display, TEXT("%d of %d requests arrived (%d lines over %d connections) in %.3f s, paths remapped: %s: %s"),
+			Result.NumUnique, NumRequests, Result.NumLines, Result.NumConnections, Seconds, Result.bAllRemapped ? TEXT("yes") : TEXT("no"), bPassed ? TEXT("passed") : TEXT("FAILED"));
+		return bPassed;
+	}
+
+private:
+	static const int32 MaxUnansweredRequests = 32;
+
+	struct FStandInResult
+	{
+		int32 NumUnique = 0;
+		int32 NumLines = 0;
+		int32 NumConnections = 0;
+		bool bAllRemapped = true;
+	};
+
+	static FStandInResult Serve(FSocket* Listener, int32 NumRequests)
+	{
+		FStandInResult Result;
+		TSet<int64> Ids;
+		const double Deadline = FPlatformTime::Seconds() + 10.0;
+		while (Ids.Num() < NumRequests && FPlatformTime::Seconds() < Deadline)
+		{
+			bool bHasConnection = false;
+			if (!Listener->WaitForPendingConnection(bHasConnection, FTimespan::FromMilliseconds(100)) || !bHasConnection) continue;
+
+			FSocket* Connection = Listener->Accept(TEXT("RiderRemoteStandInConnection"));
+			if (Connection == nullptr) continue;
+			Result.NumConnections++;
+
+			// The first connection is dropped halfway to make the client reconnect and resend
+			const int32 DropAfter = Result.NumConnections == 1 ? NumRequests / 2 : MAX_int32;
+			int32 NumLinesOnConnection = 0;
+			TArray<uint8> Buffer;
+			while (Ids.Num() < NumRequests && NumLinesOnConnection < DropAfter && FPlatformTime::Seconds() < Deadline)
+			{
+				if (!Connection->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(100))) continue;
+
+				uint8 Chunk[4096];
+				int32 BytesRead = 0;
+				if (!Connection->Recv(Chunk, sizeof(Chunk), BytesRead) || BytesRead <= 0) break;
+				Buffer.Append(Chunk, BytesRead);
+
+				int32 LineStart = 0;
+				for (int32 Index = 0; Index < Buffer.Num() && NumLinesOnConnection < DropAfter; Index++)
+				{
+					if (Buffer[Index] != '\n') continue;
+
+					const FString Line(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Buffer.GetData()) + LineStart, Index - LineStart).Get(), Index - LineStart);
+					const int32 IdStart = Line.Find(TEXT("\"id\":"));
+					if (IdStart != INDEX_NONE)
+					{
+						Ids.Add(FCString::Atoi64(*Line + IdStart + 5));
+					}
+					// JSON escapes the quotes around each argument
+					Result.bAllRemapped &= !Line.Contains(TEXT("\\\"/local/")) && Line.Contains(TEXT("\\\"/remote/Project.uproject"))
+						&& Line.Contains(TEXT("\\\"/mnt/local/Shared.h"));
+					Result.NumLines++;
+					NumLinesOnConnection++;
+					LineStart = Index + 1;
+
+					int32 BytesSent = 0;
+					Connection->Send(reinterpret_cast<const uint8*>("ok\n"), 3, BytesSent);
+				}
+				Buffer.RemoveAt(0, LineStart);
+			}
+			Connection->Close();
+			ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Connection);
+		}
+		Result.NumUnique = Ids.Num();
+		return Result;
+	}
+};
+
+static FAutoConsoleCommand RiderRemoteTransportCheckCommand(
+	TEXT("Rider.Check.RemoteTransport"),
+	TEXT("Sends requests through the remote transport to a loopback stand-in host that drops the first connection. Args: [NumRequests=100]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumRequests = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 2) : 100;
+		FRiderRemoteTransportCheck::Run(NumRequests);
+	}));
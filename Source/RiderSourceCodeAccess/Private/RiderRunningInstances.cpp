@@ -0,0 +1,106 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderRunningInstances.h"
+
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+namespace RiderRunningInstances
+{
+	struct FRunningProcess
+	{
+		FString Executable;
+		uint32 ProcessId = 0;
+		uint32 ParentProcessId = 0;
+	};
+
+	static FCriticalSection ScanCriticalSection;
+	static TArray<FRunningProcess> RunningProcesses;
+	static double ScanTime = 0.0;
+	static bool bScanned = false;
+
+	static TArray<FRunningProcess> GetRunningProcesses()
+	{
+		FScopeLock Lock(&ScanCriticalSection);
+		const double Now = FPlatformTime::Seconds();
+		if (!bScanned || Now - ScanTime > ScanLifetimeSeconds)
+		{
+			RunningProcesses.Reset();
+			FPlatformProcess::FProcEnumerator ProcEnumerator;
+			while (ProcEnumerator.MoveNext())
+			{
+				const FPlatformProcess::FProcEnumInfo ProcInfo = ProcEnumerator.GetCurrent();
+				FString FullPath = ProcInfo.GetFullPath();
+				if (FullPath.IsEmpty()) continue;
+
+				FPaths::NormalizeFilename(FullPath);
+				RunningProcesses.Add({ MoveTemp(FullPath), ProcInfo.GetPID(), ProcInfo.GetParentPID() });
+			}
+			ScanTime = Now;
+			bScanned = true;
+		}
+		return RunningProcesses;
+	}
+
+	/** Every process of an install runs from below this directory, the JVM on Linux included */
+	static FString GetInstallRoot(const FString& LauncherPath)
+	{
+		FString Path = LauncherPath;
+		FPaths::NormalizeFilename(Path);
+
+		// Mac launchers are <Rider.app>/Contents/MacOS/rider, the bundle is the root
+		static const FString MacLauncherDir = TEXT("/Contents/MacOS/");
+		const int32 MacLauncherDirIndex = Path.Find(MacLauncherDir, ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+		if (MacLauncherDirIndex != INDEX_NONE) return Path.Left(MacLauncherDirIndex) + TEXT("/");
+
+		// Elsewhere the launcher sits in <root>/bin. Toolbox shell scripts live outside the install, their directory would match unrelated processes
+		const FString BinDir = FPaths::GetPath(Path);
+		if (FPaths::GetCleanFilename(BinDir) != TEXT("bin")) return {};
+		return FPaths::GetPath(BinDir) + TEXT("/");
+	}
+
+	bool IsInstallRunning(const FString& LauncherPath)
+	{
+		const FString Root = GetInstallRoot(LauncherPath);
+		if (Root.IsEmpty()) return false;
+
+		return GetRunningProcesses().ContainsByPredicate([&Root](const FRunningProcess& Process)
+		{
+			return Process.Executable.StartsWith(Root);
+		});
+	}
+
+	TOptional<FInstallInfo> FindNewestRunning(const TArray<FInstallInfo>& InstallInfos)
+	{
+		for (int32 Index = InstallInfos.Num() - 1; Index >= 0; Index--)
+		{
+			if (IsInstallRunning(InstallInfos[Index].GetPath())) return InstallInfos[Index];
+		}
+		return {};
+	}
+
+	TOptional<uint32> FindInstanceProcessId(const FString& LauncherPath, uint32 LauncherProcessId)
+	{
+		const FString Root = GetInstallRoot(LauncherPath);
+		if (Root.IsEmpty()) return {};
+
+		const TArray<FRunningProcess> Running = GetRunningProcesses();
+		const auto IsInstallProcess = [&Root, &Running](uint32 ProcessId)
+		{
+			return Running.ContainsByPredicate([&Root, ProcessId](const FRunningProcess& Process)
+			{
+				return Process.ProcessId == ProcessId && Process.Executable.StartsWith(Root);
+			});
+		};
+
+		// The backend, fsnotifier and other helpers also run from the install, the IDE is the one none of them started
+		for (const FRunningProcess& Process : Running)
+		{
+			if (Process.ProcessId == LauncherProcessId || Process.ParentProcessId == LauncherProcessId) continue;
+			if (Process.Executable.StartsWith(Root) && !IsInstallProcess(Process.ParentProcessId)) return Process.ProcessId;
+		}
+		return {};
+	}
+}
@@ -0,0 +1,25 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "RiderPathLocator/RiderPathLocator.h"
+
+namespace RiderRunningInstances
+{
+	/**
+	 * The newest of InstallInfos (sorted oldest first) that has a process running, unset if none is running.
+	 * Processes are enumerated at most once per ScanLifetimeSeconds, so a burst of requests costs a single scan.
+	 */
+	TOptional<FInstallInfo> FindNewestRunning(const TArray<FInstallInfo>& InstallInfos);
+
+	/**
+	 * The IDE instance of LauncherPath's install other than the launcher process itself. A launcher started while the
+	 * install is running hands its request to that instance and exits. Rider runs a single instance per install.
+	 */
+	TOptional<uint32> FindInstanceProcessId(const FString& LauncherPath, uint32 LauncherProcessId);
+
+	/** Whether any process of LauncherPath's install is running, false for launchers outside their install such as Toolbox scripts */
+	bool IsInstallRunning(const FString& LauncherPath);
+
+	static constexpr double ScanLifetimeSeconds = 2.0;
+}
@@ -0,0 +1,277 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderSlnProjectFiles.h"
+
+#include "RiderSourceTree.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRiderSlnProjectFiles, Log, All);
+
+namespace RiderSlnProjectFiles
+{
+
+struct FProjectFile
+{
+	FString Path;
+	FString Content;
+	TOptional<FString> FiltersContent;
+	bool bDirty = false;
+};
+
+/** Project file paths by project name */
+TMap<FString, FString> GetProjectFilePaths(const FString& SolutionPath)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *SolutionPath)) return {};
+
+	// Project("{type}") = "Name", "Relative\Path.vcxproj", "{guid}"
+	TMap<FString, FString> Result;
+	const FString SolutionDir = FPaths::GetPath(SolutionPath);
+	for (const FString& Line : Lines)
+	{
+		if (!Line.StartsWith(TEXT("Project("))) continue;
+
+		TArray<FString> Parts;
+		Line.ParseIntoArray(Parts, TEXT("\""));
+		if (Parts.Num() < 6 || !Parts[5].EndsWith(TEXT(".vcxproj"))) continue;
+
+		FString ProjectFilePath = FPaths::ConvertRelativePathToFull(SolutionDir, Parts[5]);
+		FPaths::NormalizeFilename(ProjectFilePath);
+		Result.Add(Parts[3], ProjectFilePath);
+	}
+	return Result;
+}
+
+/**
+ * The one project UnrealBuildTool puts a module's files in: the game project for modules of a .uproject and its plugins,
+ * a program's own project for programs, and the engine project for everything else under the engine directory
+ */
+TOptional<FString> FindOwningProject(const FString& ModuleDir, const TMap<FString, FString>& Projects)
+{
+	FString EngineDir = FPaths::ConvertRelativePathToFull(FPaths::EngineDir());
+	FPaths::NormalizeDirectoryName(EngineDir);
+	for (FString Dir = ModuleDir; !Dir.IsEmpty() && !FPaths::IsSamePath(Dir, EngineDir); Dir = FPaths::GetPath(Dir))
+	{
+		const FString Name = FPaths::GetCleanFilename(Dir);
+		if (!Projects.Contains(Name)) continue;
+
+		const bool bIsProgram = FPaths::GetCleanFilename(FPaths::GetPath(Dir)) == TEXT("Programs");
+		if (bIsProgram || FPaths::FileExists(FPaths::Combine(Dir, Name + TEXT(".uproject")))) return Projects[Name];
+	}
+	if (!FPaths::IsUnderDirectory(ModuleDir, EngineDir)) return {};
+
+	for (const TCHAR* EngineProjectName : { TEXT("UE5"), TEXT("UE4") })
+	{
+		if (const FString* EngineProject = Projects.Find(EngineProjectName)) return *EngineProject;
+	}
+	return {};
+}
+
+bool LoadProjectFile(const FString& ProjectFilePath, FProjectFile& OutProjectFile)
+{
+	OutProjectFile.Path = ProjectFilePath;
+	if (!FFileHelper::LoadFileToString(OutProjectFile.Content, *ProjectFilePath)) return false;
+
+	FString FiltersContent;
+	if (FFileHelper::LoadFileToString(FiltersContent, *(ProjectFilePath + TEXT(".filters"))))
+	{
+		OutProjectFile.FiltersContent = MoveTemp(FiltersContent);
+	}
+	return true;
+}
+
+/** Paths in project files are relative to the project file, with backslashes */
+FString GetItemPath(const FString& Path, const FString& ProjectFilePath)
+{
+	FString Result = Path;
+	FPaths::MakePathRelativeTo(Result, *ProjectFilePath);
+	Result.ReplaceInline(TEXT("/"), TEXT("\\"));
+	return Result;
+}
+
+const TCHAR* GetItemType(const FString& SourcePath)
+{
+	static const TSet<FString> HeaderExtensions = { TEXT("h"), TEXT("hh"), TEXT("hpp"), TEXT("hxx"), TEXT("inl") };
+	static const TSet<FString> CompileExtensions = { TEXT("c"), TEXT("cc"), TEXT("cpp"), TEXT("cxx") };
+
+	const FString Extension = FPaths::GetExtension(SourcePath);
+	if (HeaderExtensions.Contains(Extension)) return TEXT("ClInclude");
+	if (CompileExtensions.Contains(Extension)) return TEXT("ClCompile");
+	return TEXT("None");
+}
+
+FString GetLineEnding(const FString& Content)
+{
+	return Content.Contains(TEXT("\r\n")) ? TEXT("\r\n") : TEXT("\n");
+}
+
+/** Start of the line holding the first item whose path starts with ItemPathPrefix, preferring items of the given type */
+int32 FindItemLine(const FString& Content, const FString& ItemPathPrefix, const TCHAR* ItemType, bool bDirectChildOnly = false)
+{
+	int32 Index = INDEX_NONE;
+	for (const FString& Pattern : { FString::Printf(TEXT("<%s Include=\"%s"), ItemType, *ItemPathPrefix), FString::Printf(TEXT(" Include=\"%s"), *ItemPathPrefix) })
+	{
+		for (Index = Content.Find(Pattern); Index != INDEX_NONE; Index = Content.Find(Pattern, ESearchCase::IgnoreCase, ESearchDir::FromStart, Index + 1))
+		{
+			if (!bDirectChildOnly) break;
+
+			const int32 NameStart = Index + Pattern.Len();
+			const int32 NameEnd = Content.Find(TEXT("\""), ESearchCase::CaseSensitive, ESearchDir::FromStart, NameStart);
+			const int32 Separator = Content.Find(TEXT("\\"), ESearchCase::CaseSensitive, ESearchDir::FromStart, NameStart);
+			if (Separator == INDEX_NONE || Separator > NameEnd) break;
+		}
+		if (Index != INDEX_NONE) break;
+	}
+	if (Index == INDEX_NONE) return INDEX_NONE;
+
+	while (Index > 0 && Content[Index - 1] != TEXT('\n'))
+	{
+		Index--;
+	}
+	return Index;
+}
+
+FString GetIndentation(const FString& Content, int32 LineStart)
+{
+	int32 End = LineStart;
+	while (End < Content.Len() && (Content[End] == TEXT(' ') || Content[End] == TEXT('\t')))
+	{
+		End++;
+	}
+	return Content.Mid(LineStart, End - LineStart);
+}
+
+bool AddItem(FProjectFile& ProjectFile, const FString& ItemPath, const FString& ItemDir, const FString& ModuleDir, const TCHAR* ItemType)
+{
+	if (ProjectFile.Content.Contains(FString::Printf(TEXT(" Include=\"%s\""), *ItemPath))) return true;
+
+	const int32 LineStart = FindItemLine(ProjectFile.Content, ModuleDir + TEXT("\\"), ItemType);
+	if (LineStart == INDEX_NONE) return false;
+
+	const FString Indentation = GetIndentation(ProjectFile.Content, LineStart);
+	ProjectFile.Content.InsertAt(LineStart, FString::Printf(TEXT("%s<%s Include=\"%s\" />%s"), *Indentation, ItemType, *ItemPath, *GetLineEnding(ProjectFile.Content)));
+	ProjectFile.bDirty = true;
+
+	if (!ProjectFile.FiltersContent.IsSet()) return true;
+
+	// Reuse the filter of a sibling so the file shows up in its folder, without one it lands at the project root
+	FString& Filters = ProjectFile.FiltersContent.GetValue();
+	if (Filters.Contains(FString::Printf(TEXT(" Include=\"%s\""), *ItemPath))) return true;
+
+	const int32 SiblingStart = FindItemLine(Filters, ItemDir + TEXT("\\"), ItemType, true);
+	if (SiblingStart == INDEX_NONE) return true;
+
+	static const FString FilterClose = TEXT("</Filter>");
+	const int32 SiblingInclude = Filters.Find(TEXT(" Include=\""), ESearchCase::CaseSensitive, ESearchDir::FromStart, SiblingStart);
+	const int32 NextInclude = Filters.Find(TEXT(" Include=\""), ESearchCase::CaseSensitive, ESearchDir::FromStart, SiblingInclude + 1);
+	const int32 FilterStart = Filters.Find(TEXT("<Filter>"), ESearchCase::CaseSensitive, ESearchDir::FromStart, SiblingInclude);
+	const int32 FilterEnd = Filters.Find(FilterClose, ESearchCase::CaseSensitive, ESearchDir::FromStart, SiblingInclude);
+	if (FilterStart == INDEX_NONE || FilterEnd == INDEX_NONE || (NextInclude != INDEX_NONE && FilterEnd > NextInclude)) return true;
+
+	const FString Filter = Filters.Mid(FilterStart, FilterEnd + FilterClose.Len() - FilterStart);
+	const FString FiltersIndentation = GetIndentation(Filters, SiblingStart);
+	const FString LineEnding = GetLineEnding(Filters);
+	Filters.InsertAt(SiblingStart, FString::Printf(TEXT("%s<%s Include=\"%s\">%s%s  %s%s%s</%s>%s"),
+		*FiltersIndentation, ItemType, *ItemPath, *LineEnding,
+		*FiltersIndentation, *Filter, *LineEnding,
+		*FiltersIndentation, ItemType, *LineEnding));
+	return true;
+}
+
+/** Writes every changed file aside first and only then swaps them in, a failed write leaves all projects untouched */
+bool SaveProjectFiles(const TArray<FProjectFile*>& ProjectFiles)
+{
+	TArray<TPair<FString, FString>> Swaps;
+	auto WriteAside = [&Swaps](const FString& Content, const FString& Path)
+	{
+		const FString TempPath = Path + TEXT(".") + FGuid::NewGuid().ToString();
+		if (!FFileHelper::SaveStringToFile(Content, *TempPath, FFileHelper::EEncodingOptions::ForceUTF8)) return false;
+
+		Swaps.Emplace(Path, TempPath);
+		return true;
+	};
+
+	bool bWritten = true;
+	for (const FProjectFile* ProjectFile : ProjectFiles)
+	{
+		bWritten = WriteAside(ProjectFile->Content, ProjectFile->Path)
+			&& (!ProjectFile->FiltersContent.IsSet() || WriteAside(ProjectFile->FiltersContent.GetValue(), ProjectFile->Path + TEXT(".filters")));
+		if (!bWritten) break;
+	}
+
+	bool bSwapped = bWritten;
+	for (const TPair<FString, FString>& Swap : Swaps)
+	{
+		if (bSwapped && !IFileManager::Get().Move(*Swap.Key, *Swap.Value, true, true))
+		{
+			UE_LOG(LogRiderSlnProjectFiles, Log, TEXT("Couldn't replace %s"), *Swap.Key);
+			bSwapped = false;
+		}
+		IFileManager::Get().Delete(*Swap.Value, false, false, true);
+	}
+	return bSwapped;
+}
+
+bool AddSourceFiles(const FString& SolutionPath, const TArray<FString>& AbsoluteSourcePaths, const TArray<FString>& AvailableModules)
+{
+	const TMap<FString, FString> Projects = GetProjectFilePaths(SolutionPath);
+	if (Projects.Num() == 0) return false;
+
+	// Only the projects owning the added files are read, the engine project alone is tens of megabytes
+	TMap<FString, FProjectFile> ProjectFiles;
+	for (const FString& AbsoluteSourcePath : AbsoluteSourcePaths)
+	{
+		FString SourcePath = FPaths::ConvertRelativePathToFull(AbsoluteSourcePath);
+		FPaths::NormalizeFilename(SourcePath);
+
+		const TOptional<FString> ModuleBuildFile = RiderSourceTree::FindModuleBuildFile(SourcePath, AvailableModules);
+		if (!ModuleBuildFile.IsSet())
+		{
+			UE_LOG(LogRiderSlnProjectFiles, Log, TEXT("No module owns %s"), *SourcePath);
+			return false;
+		}
+		FString ModuleDir = FPaths::ConvertRelativePathToFull(FPaths::GetPath(ModuleBuildFile.GetValue()));
+		FPaths::NormalizeDirectoryName(ModuleDir);
+
+		const TOptional<FString> ProjectFilePath = FindOwningProject(ModuleDir, Projects);
+		FProjectFile* ProjectFile = ProjectFilePath.IsSet() ? ProjectFiles.Find(ProjectFilePath.GetValue()) : nullptr;
+		if (ProjectFilePath.IsSet() && ProjectFile == nullptr)
+		{
+			FProjectFile LoadedProjectFile;
+			if (LoadProjectFile(ProjectFilePath.GetValue(), LoadedProjectFile))
+			{
+				ProjectFile = &ProjectFiles.Add(ProjectFilePath.GetValue(), MoveTemp(LoadedProjectFile));
+			}
+		}
+
+		const bool bAdded = ProjectFile != nullptr && AddItem(*ProjectFile, GetItemPath(SourcePath, ProjectFile->Path),
+			GetItemPath(FPaths::GetPath(SourcePath), ProjectFile->Path), GetItemPath(ModuleDir, ProjectFile->Path), GetItemType(SourcePath));
+		if (!bAdded)
+		{
+			UE_LOG(LogRiderSlnProjectFiles, Log, TEXT("No project file lists module %s"), *ModuleDir);
+			return false;
+		}
+	}
+
+	TArray<FProjectFile*> DirtyProjectFiles;
+	for (TPair<FString, FProjectFile>& ProjectFile : ProjectFiles)
+	{
+		if (ProjectFile.Value.bDirty)
+		{
+			DirtyProjectFiles.Add(&ProjectFile.Value);
+		}
+	}
+	if (!SaveProjectFiles(DirtyProjectFiles)) return false;
+
+	for (const FProjectFile* ProjectFile : DirtyProjectFiles)
+	{
+		UE_LOG(LogRiderSlnProjectFiles, Log, TEXT("Added source files to %s"), *ProjectFile->Path);
+	}
+	return true;
+}
+
+}
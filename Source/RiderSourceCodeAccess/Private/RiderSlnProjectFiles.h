@@ -0,0 +1,17 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Edits the .vcxproj files generated by UnrealBuildTool in place, Rider reloads only the projects that changed */
+namespace RiderSlnProjectFiles
+{
+	/**
+	 * Adds each file next to the other items of its module in the project UnrealBuildTool generated for that module.
+	 * AvailableModules are the paths to the modules' .Build.cs files.
+	 * Returns false if any file couldn't be placed, the caller then has to regenerate the solution. No project is
+	 * changed unless all of them could be written.
+	 */
+	bool AddSourceFiles(const FString& SolutionPath, const TArray<FString>& AbsoluteSourcePaths, const TArray<FString>& AvailableModules);
+}
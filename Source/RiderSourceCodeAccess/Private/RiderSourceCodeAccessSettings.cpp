@@ -0,0 +1,50 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderSourceCodeAccessSettings.h"
+
+#include "Misc/CommandLine.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/Parse.h"
+#include "Misc/ScopeLock.h"
+
+static const TCHAR* SettingsSection = TEXT("RiderSourceCodeAccess");
+
+static FRiderSourceCodeAccessSettings LoadSettings()
+{
+	FRiderSourceCodeAccessSettings Settings;
+	if (GConfig != nullptr)
+	{
+		GConfig->GetBool(SettingsSection, TEXT("bDeferDiscovery"), Settings.bDeferDiscovery, GEditorIni);
+		GConfig->GetInt(SettingsSection, TEXT("InstallCacheLifetimeSeconds"), Settings.InstallCacheLifetimeSeconds, GEditorIni);
+		GConfig->GetFloat(SettingsSection, TEXT("DiscoveryTimeBudgetSeconds"), Settings.DiscoveryTimeBudgetSeconds, GEditorIni);
+		GConfig->GetBool(SettingsSection, TEXT("bPrelaunchIDE"), Settings.bPrelaunchIDE, GEditorIni);
+		GConfig->GetBool(SettingsSection, TEXT("bLightEditFileOpens"), Settings.bLightEditFileOpens, GEditorIni);
+		GConfig->GetFloat(SettingsSection, TEXT("LightEditUpgradeDelaySeconds"), Settings.LightEditUpgradeDelaySeconds, GEditorIni);
+		GConfig->GetString(SettingsSection, TEXT("RemoteHost"), Settings.RemoteHost, GEditorIni);
+		GConfig->GetArray(SettingsSection, TEXT("RemotePathMap"), Settings.RemotePathMap, GEditorIni);
+		GConfig->GetBool(SettingsSection, TEXT("bExportProjectModel"), Settings.bExportProjectModel, GEditorIni);
+		GConfig->GetString(SettingsSection, TEXT("CallTracePath"), Settings.CallTracePath, GEditorIni);
+	}
+	Settings.bDeferDiscovery |= FParse::Param(FCommandLine::Get(), TEXT("RiderDeferDiscovery"));
+	return Settings;
+}
+
+static FCriticalSection SettingsOverrideCriticalSection;
+static TOptional<FRiderSourceCodeAccessSettings> SettingsOverride;
+
+FRiderSourceCodeAccessSettings FRiderSourceCodeAccessSettings::Get()
+{
+	{
+		FScopeLock Lock(&SettingsOverrideCriticalSection);
+		if (SettingsOverride.IsSet()) return SettingsOverride.GetValue();
+	}
+
+	static const FRiderSourceCodeAccessSettings Settings = LoadSettings();
+	return Settings;
+}
+
+void FRiderSourceCodeAccessSettings::SetOverride(const TOptional<FRiderSourceCodeAccessSettings>& Settings)
+{
+	FScopeLock Lock(&SettingsOverrideCriticalSection);
+	SettingsOverride = Settings;
+}
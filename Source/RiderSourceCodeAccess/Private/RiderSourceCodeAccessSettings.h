@@ -0,0 +1,48 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Plugin settings, read once from the [RiderSourceCodeAccess] section of the editor config (e.g. DefaultEditor.ini) */
+struct FRiderSourceCodeAccessSettings
+{
+	/** Postpone Rider discovery until an accessor is actually used. Also enabled by -RiderDeferDiscovery */
+	bool bDeferDiscovery = false;
+
+	/** How long discovery results are shared between processes through the install cache file, 0 disables the cache */
+	int32 InstallCacheLifetimeSeconds = 600;
+
+	/** How long the editor waits for discovery before going on with the installs found so far, 0 waits indefinitely */
+	float DiscoveryTimeBudgetSeconds = 5.0f;
+
+	/** Start Rider with the current solution once the editor finished loading, so the first open request doesn't wait for a cold start */
+	bool bPrelaunchIDE = false;
+
+	/** Open files in Rider's LightEdit mode while no Rider is running or there is no solution yet, the solution follows in the background */
+	bool bLightEditFileOpens = false;
+
+	/** Delay between a LightEdit open and loading the solution behind it */
+	float LightEditUpgradeDelaySeconds = 5.0f;
+
+	/** host:port of a Rider host to forward open requests to instead of starting Rider locally, empty launches locally */
+	FString RemoteHost;
+
+	/** LocalPrefix|RemotePrefix pairs replacing the leading directories of quoted paths sent to RemoteHost, e.g. +RemotePathMap=/srv/UE|D:/UE */
+	TArray<FString> RemotePathMap;
+
+	/**
+	 * Write Intermediate/Rider/ProjectModel.json from UnrealBuildTool's target export for Rider's Uproject model.
+	 * Off by default, every export runs UnrealBuildTool and waits for builds and Live Coding to finish first
+	 */
+	bool bExportProjectModel = false;
+
+	/** Record the editor's accessor calls to this file for Rider.Benchmark.Replay, written on shutdown. Empty disables recording */
+	FString CallTracePath;
+
+	/** A copy, so an override set on another thread can't change or free the settings a caller is reading */
+	static FRiderSourceCodeAccessSettings Get();
+
+	/** Replaces the configured settings until cleared with an unset value, for benchmarks that must not reach the user's IDE. Thread safe */
+	static void SetOverride(const TOptional<FRiderSourceCodeAccessSettings>& Settings);
+};
@@ -3,12 +3,23 @@
 #include "RiderSourceCodeAccessor.h"
 
 #include "RiderPathLocator/RiderPathLocator.h"
-
+#include "RiderInstanceRouter.h"
+#include "RiderPathCaseIndex.h"
+#include "RiderRemoteTransport.h"
+#include "RiderRunningInstances.h"
+#include "RiderSlnProjectFiles.h"
+#include "RiderSourceCodeAccessSettings.h"
+#include "RiderSourcePathIndex.h"
+#include "RiderSymbolIndex.h"
+#include "RiderTicker.h"
+
+#include "Async/Async.h"
 #include "Modules/ModuleManager.h"
 #include "Misc/App.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 #include "Misc/ScopeLock.h"
+#include "Misc/ScopeRWLock.h"
 #include "Misc/UProjectInfo.h"
 #include "DesktopPlatformModule.h"
 #include "ISourceCodeAccessModule.h"
@@ -20,6 +31,10 @@
 #include "Misc/MessageDialog.h"
 #include "Widgets/Notifications/SNotificationList.h"
 
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#endif
+
 #define LOCTEXT_NAMESPACE "RiderSourceCodeAccessor"
 
 DEFINE_LOG_CATEGORY_STATIC(LogRiderAccessor, Log, All);
@@ -27,33 +42,49 @@ DEFINE_LOG_CATEGORY_STATIC(LogRiderAccessor, Log, All);
 namespace RSCA
 {
 
+/** Path as given, or with its on-disk casing for paths produced on case-insensitive file systems */
+TOptional<FString> FindFile(const FString& Path)
+{
+	if (FPaths::FileExists(Path)) return Path;
+
+	FRiderPathCaseIndex* PathCaseIndex = FRiderPathCaseIndex::Get();
+	if (PathCaseIndex == nullptr) return {};
+	return PathCaseIndex->Resolve(Path);
+}
+
 TOptional<FString> ResolvePathToFile(const FString& FullPath)
 {
 	FString Path = FullPath;
 	if (FPaths::IsRelative(Path))
 		Path = FPaths::ConvertRelativePathToFull(Path);
 
-	if (!FPaths::FileExists(Path))
-	{
-		static const TArray<FString> SubDirs = {
-			"/Engine/Source/",
-			"/Engine/Plugins/"
-		};
+	TOptional<FString> ExistingPath = FindFile(Path);
+	if (ExistingPath.IsSet()) return ExistingPath;
 
-		FString EngineRootDir = FPaths::RootDir();
-		FPaths::NormalizeFilename(Path);
-		int32 Index = INDEX_NONE;
-		for (const FString& SubDir : SubDirs)
-		{
-			Index = Path.Find(SubDir);
-			if (Index != INDEX_NONE) break;
-		}
-		if (Index == INDEX_NONE) return {};
+	static const TArray<FString> SubDirs = {
+		"/Engine/Source/",
+		"/Engine/Plugins/"
+	};
 
-		Path = EngineRootDir.Append(Path.RightChop(Index));
-		if (!FPaths::FileExists(Path)) return {};
+	FString EngineRootDir = FPaths::RootDir();
+	FPaths::NormalizeFilename(Path);
+	int32 Index = INDEX_NONE;
+	for (const FString& SubDir : SubDirs)
+	{
+		Index = Path.Find(SubDir);
+		if (Index != INDEX_NONE) break;
 	}
-	return {Path};
+
+	if (Index != INDEX_NONE)
+	{
+		ExistingPath = FindFile(EngineRootDir.Append(Path.RightChop(Index)));
+		if (ExistingPath.IsSet()) return ExistingPath;
+	}
+
+	// Game modules, programs and plugins from other machines only resolve by their longest matching suffix
+	const FRiderSourcePathIndex* SourcePathIndex = FRiderSourcePathIndex::Get();
+	if (SourcePathIndex == nullptr) return {};
+	return SourcePathIndex->Resolve(Path);
 }
 
 struct FCommandLineInfo
@@ -98,6 +129,29 @@ FCommandLineInfo GetPlatformAppAndArgs(const FString& App, const FString& Args)
 	return info;
 }
 
+/** Runs Info below normal CPU and IO priority through nice and ionice, which exec the app so it keeps their process id */
+FCommandLineInfo GetLowPriorityAppAndArgs(const FCommandLineInfo& Info)
+{
+#if PLATFORM_LINUX || PLATFORM_MAC
+	static const FString Nice = TEXT("/usr/bin/nice");
+	if (!FPaths::FileExists(Nice)) return Info;
+
+	FString Args = TEXT("-n 10 ");
+#if PLATFORM_LINUX
+	// Lowest best-effort level rather than the idle class, which would starve the IDE whenever the editor reads
+	static const FString IONice = TEXT("/usr/bin/ionice");
+	if (FPaths::FileExists(IONice))
+	{
+		Args += FString::Printf(TEXT("\"%s\" -c 2 -n 7 "), *IONice);
+	}
+#endif
+	Args += FString::Printf(TEXT("\"%s\" %s"), *Info.App, *Info.Args);
+	return { Nice, Args };
+#else
+	return Info;
+#endif
+}
+
 bool CheckExecutable(const FString& App)
 {
 	if(FPaths::FileExists(App) || FPaths::DirectoryExists(App))
@@ -105,22 +159,66 @@ bool CheckExecutable(const FString& App)
 		return true;
 	}
 
-	FNotificationInfo Info(FText::Format(LOCTEXT("CodeAccessorAppDoesntExist", "{0} doesn't exist"), FText::FromString(App)));
-	Info.bFireAndForget = true;
+	UE_LOG(LogRiderAccessor, Warning, TEXT("%s doesn't exist"), *App);
 
-	FSlateNotificationManager::Get().AddNotification(Info)->SetCompletionState(SNotificationItem::CS_Fail);
+	// Notifications can only be added on the game thread, opens from other threads hand theirs over
+	const auto Notify = [App]()
+	{
+		FNotificationInfo Info(FText::Format(LOCTEXT("CodeAccessorAppDoesntExist", "{0} doesn't exist"), FText::FromString(App)));
+		Info.bFireAndForget = true;
 
+		FSlateNotificationManager::Get().AddNotification(Info)->SetCompletionState(SNotificationItem::CS_Fail);
+	};
+	if (IsInGameThread())
+	{
+		Notify();
+	}
+	else
+	{
+		AsyncTask(ENamedThreads::GameThread, Notify);
+	}
 	return false;
 }
 
-bool OpenRider(const FString& ExecutablePath, const FString& Params, const FString& ErrorMessage)
+/** Instance started by Prelaunch, shared by all accessors so whichever opens something first gives it back its priority on Windows */
+static FProcHandle PrelaunchedProc;
+static FCriticalSection PrelaunchedProcCriticalSection;
+
+void RestorePrelaunchedPriority()
+{
+	FScopeLock Lock(&PrelaunchedProcCriticalSection);
+	if (!PrelaunchedProc.IsValid()) return;
+
+#if PLATFORM_WINDOWS
+	::SetPriorityClass(PrelaunchedProc.Get(), NORMAL_PRIORITY_CLASS);
+#endif
+	FPlatformProcess::CloseProc(PrelaunchedProc);
+}
+
+bool OpenRider(const FString& ExecutablePath, const FString& Params, const FString& ErrorMessage, const FString& FallbackExecutablePath = FString(), uint32* OutProcessId = nullptr)
 {
-	const FCommandLineInfo PlatformAppAndArgs = GetPlatformAppAndArgs(ExecutablePath, Params);
+	if (FRiderRemoteTransport* RemoteTransport = FRiderRemoteTransport::Get())
+	{
+		return RemoteTransport->Send(Params);
+	}
+
+	// Try the native launcher quietly first, the script next to it still works if it was removed or can't start
+	if (!FallbackExecutablePath.IsEmpty() && FPaths::FileExists(ExecutablePath))
+	{
+		const FCommandLineInfo PlatformAppAndArgs = GetPlatformAppAndArgs(ExecutablePath, Params);
+		FProcHandle Proc = FPlatformProcess::CreateProc(*PlatformAppAndArgs.App, *PlatformAppAndArgs.Args, true, true, false, OutProcessId, 0,
+														nullptr, nullptr);
+		if (Proc.IsValid()) return true;
+
+		UE_LOG(LogRiderAccessor, Verbose, TEXT("Couldn't start %s, falling back to %s"), *ExecutablePath, *FallbackExecutablePath);
+	}
+
+	const FCommandLineInfo PlatformAppAndArgs = GetPlatformAppAndArgs(FallbackExecutablePath.IsEmpty() ? ExecutablePath : FallbackExecutablePath, Params);
 	if(!CheckExecutable(PlatformAppAndArgs.App))
 	{
 		return false;
 	}
-	FProcHandle Proc = FPlatformProcess::CreateProc(*PlatformAppAndArgs.App, *PlatformAppAndArgs.Args, true, true, false, nullptr, 0,
+	FProcHandle Proc = FPlatformProcess::CreateProc(*PlatformAppAndArgs.App, *PlatformAppAndArgs.Args, true, true, false, OutProcessId, 0,
 													nullptr, nullptr);
 	const bool bResult = Proc.IsValid();
 	if (!bResult)
@@ -132,19 +230,94 @@ bool OpenRider(const FString& ExecutablePath, const FString& Params, const FStri
 	return bResult;
 }
 
+/** Opens through the install whose instance already has the solution, or through ours and remembers that it does now */
+bool OpenRiderForSolution(const FString& SolutionPath, const FString& ExecutablePath, const FString& Params, const FString& ErrorMessage, const FString& FallbackExecutablePath)
+{
+	const TOptional<FRiderInstanceRouter::FRoute> Route = FRiderInstanceRouter::Find(SolutionPath);
+	if (Route.IsSet())
+	{
+		return OpenRider(Route->ExecutablePath, Params, ErrorMessage, Route->FallbackExecutablePath);
+	}
+
+	FRiderInstanceRouter::FRoute NewRoute { ExecutablePath, FallbackExecutablePath };
+	if (!OpenRider(ExecutablePath, Params, ErrorMessage, FallbackExecutablePath, &NewRoute.ProcessId)) return false;
+
+	// Requests forwarded to a remote host start nothing here, there is no instance to route other editors to
+	if (NewRoute.ProcessId == 0) return true;
+
+	// The solution belongs to the instance that was already running, the launcher only becomes the IDE on a cold start
+	const TOptional<uint32> InstanceProcessId = RiderRunningInstances::FindInstanceProcessId(ExecutablePath, NewRoute.ProcessId);
+	if (InstanceProcessId.IsSet())
+	{
+		NewRoute.ProcessId = InstanceProcessId.GetValue();
+	}
+
+	FRiderInstanceRouter::Record(SolutionPath, NewRoute);
+	return true;
+}
+
+}
+
+class FRiderSourceCodeAccessor::FSolutionPathScopeLock
+{
+public:
+	explicit FSolutionPathScopeLock(const FRiderSourceCodeAccessor& Accessor)
+		: CriticalSection(Accessor.CachedSolutionPathCriticalSection)
+	{
+		// Only a lock that is actually contended pays for reading the clock
+		if (CriticalSection.TryLock()) return;
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		CriticalSection.Lock();
+		Accessor.SolutionPathContentionCycles += FPlatformTime::Cycles64() - StartCycles;
+	}
+
+	~FSolutionPathScopeLock()
+	{
+		CriticalSection.Unlock();
+	}
+
+private:
+	FCriticalSection& CriticalSection;
+};
+
+FRiderSourceCodeAccessor::FLaunchers FRiderSourceCodeAccessor::GetLaunchers() const
+{
+	FReadScopeLock Lock(LaunchersLock);
+	return { ExecutablePath, FallbackExecutablePath };
+}
+
+bool FRiderSourceCodeAccessor::FLaunchers::IsInstallRunning() const
+{
+	// Toolbox scripts live outside the install, the native launcher next to them still tells where it is
+	return RiderRunningInstances::IsInstallRunning(ExecutablePath) || RiderRunningInstances::IsInstallRunning(FallbackExecutablePath);
+}
+
+FString FRiderSourceCodeAccessor::GetCachedSolutionPath() const
+{
+	FSolutionPathScopeLock Lock(*this);
+	CachePathToSolution();
+	return CachedSolutionPath;
 }
 
 void FRiderSourceCodeAccessor::RefreshAvailability()
 {
+	const FLaunchers Launchers = GetLaunchers();
 	// If we have an executable path, we certainly have it installed!
-	bHasRiderInstalled = !ExecutablePath.IsEmpty() && FPaths::FileExists(ExecutablePath);
+	bHasRiderInstalled = (!Launchers.ExecutablePath.IsEmpty() && FPaths::FileExists(Launchers.ExecutablePath))
+		|| (!Launchers.FallbackExecutablePath.IsEmpty() && FPaths::FileExists(Launchers.FallbackExecutablePath))
+		|| FRiderRemoteTransport::Get() != nullptr;
 }
 
 bool FRiderSourceCodeAccessor::AddSourceFiles(const TArray<FString>& AbsoluteSourcePaths, const TArray<FString>& AvailableModules)
 {
-	// For uproject model, we're listening to changes of filesystem and will update project automatically
+	// For uproject model, we're listening to changes of filesystem and will update project automatically.
+	// Rider has no local endpoint that takes a list of added files, so there is nothing more direct to push them to
 	if(Model == EProjectModel::Uproject) return true;
-	
+
+	// Patching the generated project files only costs the files added, regenerating the solution costs the whole codebase
+	const FString SolutionPath = GetCachedSolutionPath();
+	if (FPaths::FileExists(SolutionPath) && RiderSlnProjectFiles::AddSourceFiles(SolutionPath, AbsoluteSourcePaths, AvailableModules)) return true;
+
 	// For other cases, fall back to default one
 	return false;
 }
@@ -156,8 +329,7 @@ bool FRiderSourceCodeAccessor::CanAccessSourceCode() const
 
 bool FRiderSourceCodeAccessor::DoesSolutionExist() const
 {
-	CachePathToSolution();
-	return FPaths::FileExists(CachedSolutionPath);
+	return FPaths::FileExists(GetCachedSolutionPath());
 }
 
 FText FRiderSourceCodeAccessor::GetDescriptionText() const
@@ -178,23 +350,22 @@ FText FRiderSourceCodeAccessor::GetNameText() const
 bool FRiderSourceCodeAccessor::OpenFileAtLine(const FString& FullPath, int32 LineNumber, int32)
 {
 	if (!bHasRiderInstalled) return false;
+	if (ShouldOpenLightEdit()) return OpenLightEdit({ FullPath }, LineNumber);
+
 	TOptional<FString> OptionalSolutionPath = GetSolutionPath();
 	if (!OptionalSolutionPath.IsSet()) return false;
-	
-	FString SolutionPath = OptionalSolutionPath.GetValue();
-	if (FPaths::IsRelative(SolutionPath))
-		SolutionPath = FPaths::ConvertRelativePathToFull(SolutionPath);
+	const FString SolutionPath = OptionalSolutionPath.GetValue();
 
-	const TOptional<FString> OptionalPath = RSCA::ResolvePathToFile(FullPath);
-	if(!OptionalPath.IsSet()) return false;
-	
-	const FString Path = OptionalPath.GetValue();
-	const FString Params = FString::Printf(TEXT("\"%s\" --line %d \"%s\""), *SolutionPath, LineNumber, *Path);
-	const FString ErrorMessage = FString::Printf(TEXT("Opening file (%s) at a line (%d) failed."), *Path, LineNumber);
+	const TOptional<FString> OptionalParams = GetOpenFileAtLineParams(SolutionPath, FullPath, LineNumber);
+	if(!OptionalParams.IsSet()) return false;
 
-	return HandleOpeningRider([this, &Params, &ErrorMessage]() -> bool
+	const FString Params = OptionalParams.GetValue();
+	const FString ErrorMessage = FString::Printf(TEXT("Opening file (%s) at a line (%d) failed."), *FullPath, LineNumber);
+
+	const FLaunchers Launchers = GetLaunchers();
+	return HandleOpeningRider([&SolutionPath, &Launchers, &Params, &ErrorMessage]()->bool
 	{
-		return RSCA::OpenRider(ExecutablePath, Params, ErrorMessage);
+		return RSCA::OpenRiderForSolution(SolutionPath, Launchers.ExecutablePath, Params, ErrorMessage, Launchers.FallbackExecutablePath);
 	});
 }
 
@@ -211,9 +382,10 @@ bool FRiderSourceCodeAccessor::OpenSolution()
 	const FString Params = FString::Printf(TEXT("\"%s\""), *FullPath);
 	const FString ErrorMessage = FString::Printf(TEXT("Opening solution (%s) failed."), *FullPath);
 
-	return HandleOpeningRider([this, &Params, &ErrorMessage]()->bool
+	const FLaunchers Launchers = GetLaunchers();
+	return HandleOpeningRider([&SolutionPath, &Launchers, &Params, &ErrorMessage]()->bool
 	{
-		return RSCA::OpenRider(ExecutablePath, Params, ErrorMessage);
+		return RSCA::OpenRiderForSolution(SolutionPath, Launchers.ExecutablePath, Params, ErrorMessage, Launchers.FallbackExecutablePath);
 	});
 }
 bool FRiderSourceCodeAccessor::OpenSolutionAtPath(const FString& InSolutionPath)
@@ -228,16 +400,25 @@ bool FRiderSourceCodeAccessor::OpenSolutionAtPath(const FString& InSolutionPath)
 	const FString Params = FString::Printf(TEXT("\"%s\""), *CorrectSolutionPath);
 	const FString ErrorMessage = FString::Printf(TEXT("Opening the project file (%s) failed."), *CorrectSolutionPath);
 
-	return HandleOpeningRider([this, &Params, &ErrorMessage]()->bool
+	const FLaunchers Launchers = GetLaunchers();
+	return HandleOpeningRider([&CorrectSolutionPath, &Launchers, &Params, &ErrorMessage]()->bool
 	{
-		return RSCA::OpenRider(ExecutablePath, Params, ErrorMessage);
+		return RSCA::OpenRiderForSolution(CorrectSolutionPath, Launchers.ExecutablePath, Params, ErrorMessage, Launchers.FallbackExecutablePath);
 	});
 }
 
 bool FRiderSourceCodeAccessor::HandleOpeningRider(const TFunction<bool()> Callback) const
 {
+	// The launch notifications are Slate UI, opens from other threads go without them
+	if (!IsInGameThread())
+	{
+		RSCA::RestorePrelaunchedPriority();
+		return Callback();
+	}
+
 	ISourceCodeAccessModule& SourceCodeAccessModule = FModuleManager::LoadModuleChecked<ISourceCodeAccessModule>(TEXT("SourceCodeAccess"));
 	SourceCodeAccessModule.OnLaunchingCodeAccessor().Broadcast();
+	RSCA::RestorePrelaunchedPriority();
 	const bool bResult = Callback();
 	SourceCodeAccessModule.OnDoneLaunchingCodeAccessor().Broadcast(bResult);
 	return bResult;
@@ -246,30 +427,52 @@ bool FRiderSourceCodeAccessor::HandleOpeningRider(const TFunction<bool()> Callba
 bool FRiderSourceCodeAccessor::OpenSourceFiles(const TArray<FString>& AbsoluteSourcePaths)
 {
 	if (!bHasRiderInstalled) return false;
+	if (ShouldOpenLightEdit()) return OpenLightEdit(AbsoluteSourcePaths);
 	
 	TOptional<FString> OptionalSolutionPath = GetSolutionPath();
 	if (!OptionalSolutionPath.IsSet()) return false;
+	const FString SolutionPath = OptionalSolutionPath.GetValue();
 	
-	FString SolutionPath = OptionalSolutionPath.GetValue();
-	
+	const TOptional<FString> OptionalParams = GetOpenSourceFilesParams(SolutionPath, AbsoluteSourcePaths);
+	if(!OptionalParams.IsSet()) return false;
+
+	const FString Params = OptionalParams.GetValue();
+	const FString ErrorMessage = FString::Printf(TEXT("Opening files (%s) failed."), *FString::Join(AbsoluteSourcePaths, TEXT(" ")));
+
+	const FLaunchers Launchers = GetLaunchers();
+	return HandleOpeningRider([&SolutionPath, &Launchers, &Params, &ErrorMessage]()->bool
+	{
+		return RSCA::OpenRiderForSolution(SolutionPath, Launchers.ExecutablePath, Params, ErrorMessage, Launchers.FallbackExecutablePath);
+	});
+}
+
+TOptional<FString> FRiderSourceCodeAccessor::GetOpenFileAtLineParams(const FString& InSolutionPath, const FString& FullPath, int32 LineNumber)
+{
+	FString SolutionPath = InSolutionPath;
+	if (FPaths::IsRelative(SolutionPath))
+		SolutionPath = FPaths::ConvertRelativePathToFull(SolutionPath);
+
+	const TOptional<FString> OptionalPath = RSCA::ResolvePathToFile(FullPath);
+	if(!OptionalPath.IsSet()) return {};
+
+	return FString::Printf(TEXT("\"%s\" --line %d \"%s\""), *SolutionPath, LineNumber, *OptionalPath.GetValue());
+}
+
+TOptional<FString> FRiderSourceCodeAccessor::GetOpenSourceFilesParams(const FString& InSolutionPath, const TArray<FString>& AbsoluteSourcePaths)
+{
+	FString SolutionPath = InSolutionPath;
 	if (FPaths::IsRelative(SolutionPath))
 		SolutionPath = FPaths::ConvertRelativePathToFull(SolutionPath);
 
 	FString FilePaths = "";
 	for (const FString & FullPath : AbsoluteSourcePaths) {
 		const TOptional<FString> OptionalPath = RSCA::ResolvePathToFile(FullPath);
-		if(!OptionalPath.IsSet()) return false;
+		if(!OptionalPath.IsSet()) return {};
 		const FString Path = OptionalPath.GetValue();
 		FilePaths += FString::Printf(TEXT("\"%s\" "), *Path);
 	}
 
-	const FString Params = FString::Printf(TEXT("\"%s\" %s"), *SolutionPath, *FilePaths);
-	const FString ErrorMessage = FString::Printf(TEXT("Opening files (%s) failed."), *FilePaths);
-
-	return HandleOpeningRider([this, &Params, &ErrorMessage]()->bool
-	{
-		return RSCA::OpenRider(ExecutablePath, Params, ErrorMessage);
-	});
+	return FString::Printf(TEXT("\"%s\" %s"), *SolutionPath, *FilePaths);
 }
 
 bool FRiderSourceCodeAccessor::SaveAllOpenDocuments() const
@@ -277,10 +480,55 @@ bool FRiderSourceCodeAccessor::SaveAllOpenDocuments() const
 	return false;
 }
 
-void FRiderSourceCodeAccessor::Init(const FInstallInfo& Info, EProjectModel ProjectModel, EAccessType Type)
+bool FRiderSourceCodeAccessor::Prelaunch()
+{
+	if (FRiderRemoteTransport::Get() != nullptr) return false;
+
+	const FString SolutionPath = GetCachedSolutionPath();
+	if (!FPaths::FileExists(SolutionPath)) return false;
+
+	const FLaunchers Launchers = GetLaunchers();
+	const FString& App = FPaths::FileExists(Launchers.ExecutablePath) ? Launchers.ExecutablePath : Launchers.FallbackExecutablePath;
+	if (App.IsEmpty() || Launchers.IsInstallRunning()) return false;
+
+	// Only Windows can raise the priority again without privileges, elsewhere the IDE keeps the lower priority for the session
+#if PLATFORM_WINDOWS
+	const int32 PriorityModifier = -1;
+	const RSCA::FCommandLineInfo PlatformAppAndArgs = RSCA::GetPlatformAppAndArgs(App, FString::Printf(TEXT("\"%s\""), *SolutionPath));
+#else
+	const int32 PriorityModifier = 0;
+	const RSCA::FCommandLineInfo PlatformAppAndArgs = RSCA::GetLowPriorityAppAndArgs(RSCA::GetPlatformAppAndArgs(App, FString::Printf(TEXT("\"%s\""), *SolutionPath)));
+#endif
+	uint32 ProcessId = 0;
+	FProcHandle Proc = FPlatformProcess::CreateProc(*PlatformAppAndArgs.App, *PlatformAppAndArgs.Args, true, true, false, &ProcessId, PriorityModifier,
+													nullptr, nullptr);
+	if (!Proc.IsValid())
+	{
+		UE_LOG(LogRiderAccessor, Warning, TEXT("Prelaunching %s failed."), *App);
+		return false;
+	}
+
+	UE_LOG(LogRiderAccessor, Log, TEXT("Prelaunched %s with %s"), *App, *SolutionPath);
+	FRiderInstanceRouter::Record(SolutionPath, { Launchers.ExecutablePath, Launchers.FallbackExecutablePath, ProcessId });
+	FScopeLock Lock(&RSCA::PrelaunchedProcCriticalSection);
+	FPlatformProcess::CloseProc(RSCA::PrelaunchedProc);
+	RSCA::PrelaunchedProc = Proc;
+	return true;
+}
+
+bool FRiderSourceCodeAccessor::OpenSymbol(const FString& SymbolName)
+{
+	// Only sessions that look symbols up pay for the index
+	FRiderSymbolIndex::Initialize();
+	const FRiderSymbolIndex* SymbolIndex = FRiderSymbolIndex::Get();
+	if (SymbolIndex == nullptr) return false;
+
+	const TOptional<FRiderSymbolIndex::FSymbolLocation> Location = SymbolIndex->FindBest(SymbolName);
+	return Location.IsSet() && OpenFileAtLine(Location->File, Location->Line);
+}
+
+FName FRiderSourceCodeAccessor::MakeName(const FInstallInfo& Info, EProjectModel ProjectModel, EAccessType Type)
 {
-	Model = ProjectModel; 
-	ExecutablePath = Info.Path;
 	FString SuffixText = "";
 	switch (Info.InstallType) {
 		case FInstallInfo::EInstallType::Installed: SuffixText = TEXT("(installed)"); break;
@@ -304,12 +552,90 @@ void FRiderSourceCodeAccessor::Init(const FInstallInfo& Info, EProjectModel Proj
 	{
 		NewName = *FString::Format(TEXT("Rider{0}"), { UprojectSuffix });
 	}
+	return *NewName;
+}
 
-	RiderName = *NewName;
+void FRiderSourceCodeAccessor::Init(const FInstallInfo& Info, EProjectModel ProjectModel, EAccessType Type)
+{
+	Model = ProjectModel; 
+	{
+		FWriteScopeLock Lock(LaunchersLock);
+		if (Info.NativeLauncherPath.IsEmpty())
+		{
+			ExecutablePath = Info.GetPath();
+			FallbackExecutablePath.Empty();
+		}
+		else
+		{
+			ExecutablePath = Info.NativeLauncherPath;
+			FallbackExecutablePath = Info.GetPath();
+		}
+	}
+	RiderName = MakeName(Info, ProjectModel, Type);
 	
 	RefreshAvailability();
+
+	// Accessors are created by whichever thread first needs them, so this resolves off the game thread as well
+	GetCachedSolutionPath();
+}
+
+
+TOptional<FString> FRiderSourceCodeAccessor::GetLightEditParams(const TArray<FString>& AbsoluteSourcePaths, int32 LineNumber)
+{
+	FString Params = TEXT("-e");
+	if (LineNumber != INDEX_NONE)
+	{
+		Params += FString::Printf(TEXT(" --line %d"), LineNumber);
+	}
+	for (const FString& FullPath : AbsoluteSourcePaths)
+	{
+		const TOptional<FString> OptionalPath = RSCA::ResolvePathToFile(FullPath);
+		if(!OptionalPath.IsSet()) return {};
+		Params += FString::Printf(TEXT(" \"%s\""), *OptionalPath.GetValue());
+	}
+	return Params;
 }
 
+bool FRiderSourceCodeAccessor::ShouldOpenLightEdit() const
+{
+	if (!FRiderSourceCodeAccessSettings::Get().bLightEditFileOpens || FRiderRemoteTransport::Get() != nullptr) return false;
+
+	// A running Rider either has the solution already or is about to, there's nothing to skip then
+	if (!FPaths::FileExists(GetCachedSolutionPath())) return true;
+
+	return !GetLaunchers().IsInstallRunning();
+}
+
+bool FRiderSourceCodeAccessor::OpenLightEdit(const TArray<FString>& AbsoluteSourcePaths, int32 LineNumber)
+{
+	const TOptional<FString> OptionalParams = GetLightEditParams(AbsoluteSourcePaths, LineNumber);
+	if(!OptionalParams.IsSet()) return false;
+
+	const FString Params = OptionalParams.GetValue();
+	const FString ErrorMessage = FString::Printf(TEXT("Opening files (%s) in LightEdit failed."), *FString::Join(AbsoluteSourcePaths, TEXT(" ")));
+	const FLaunchers Launchers = GetLaunchers();
+	const bool bResult = HandleOpeningRider([&Launchers, &Params, &ErrorMessage]()->bool
+	{
+		return RSCA::OpenRider(Launchers.ExecutablePath, Params, ErrorMessage, Launchers.FallbackExecutablePath);
+	});
+	if (!bResult || bLightEditUpgradeScheduled.Exchange(true)) return bResult;
+
+	// Load the solution into the same instance once the files are up, accessors can be recreated meanwhile so nothing refers back to this one
+	const FString SolutionPath = GetCachedSolutionPath();
+	FRiderTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([SolutionPath, App = Launchers.ExecutablePath, FallbackApp = Launchers.FallbackExecutablePath](float)
+	{
+		// Generating a missing solution takes minutes and asks first, that stays an explicit Open Solution
+		if (!FPaths::FileExists(SolutionPath))
+		{
+			UE_LOG(LogRiderAccessor, Log, TEXT("No solution at %s, staying in LightEdit"), *SolutionPath);
+			return false;
+		}
+		const FString FullPath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*SolutionPath);
+		RSCA::OpenRiderForSolution(SolutionPath, App, FString::Printf(TEXT("\"%s\""), *FullPath), FString::Printf(TEXT("Opening solution (%s) failed."), *FullPath), FallbackApp);
+		return false;
+	}), FRiderSourceCodeAccessSettings::Get().LightEditUpgradeDelaySeconds);
+	return true;
+}
 
 void FRiderSourceCodeAccessor::CachePathToUproject() const
 {
@@ -337,9 +663,7 @@ void FRiderSourceCodeAccessor::CachePathToSln() const
 		}
 		else
 		{
-			const FProjectDescriptor* CurrentProject = IProjectManager::Get().GetCurrentProject();
-
-			if (CurrentProject == nullptr || CurrentProject->Modules.Num() == 0)
+			if (!HasCodeModules())
 			{
 				CachedSolutionPath = TEXT("");
 			}
@@ -352,24 +676,41 @@ void FRiderSourceCodeAccessor::CachePathToSln() const
 	}
 }
 
+bool FRiderSourceCodeAccessor::HasCodeModules()
+{
+	if (IsInGameThread())
+	{
+		const FProjectDescriptor* CurrentProject = IProjectManager::Get().GetCurrentProject();
+		return CurrentProject != nullptr && CurrentProject->Modules.Num() > 0;
+	}
+
+	// The project manager belongs to the game thread, the descriptor on disk has the same module list
+	FProjectDescriptor Descriptor;
+	FText FailReason;
+	return FPaths::IsProjectFilePathSet() && Descriptor.Load(FPaths::GetProjectFilePath(), FailReason) && Descriptor.Modules.Num() > 0;
+}
+
 void FRiderSourceCodeAccessor::CachePathToSolution() const
 {
-	if(IsInGameThread())
+	// The game thread refreshes the path on every call, other threads resolve it once when an accessor is first used there
+	if (!IsInGameThread() && !CachedSolutionPath.IsEmpty()) return;
+
+	if (Model == EProjectModel::Sln)
 	{
-		if (Model == EProjectModel::Sln)
-		{
-			CachePathToSln();
-		}			
-		else if (Model == EProjectModel::Uproject)
-		{
-			CachePathToUproject();
-		}			
+		CachePathToSln();
+	}
+	else if (Model == EProjectModel::Uproject)
+	{
+		CachePathToUproject();
 	}
 }
 
 bool FRiderSourceCodeAccessor::TryGenerateSlnFile() const
 {
 #if WITH_EDITOR
+	// Asking needs a dialog, which only the game thread can show
+	if (!IsInGameThread()) return false;
+
 	const FText Message = LOCTEXT("RSCA_AskGenerateSolutionFile", "Project file is not available.\nGenerate project file?");
 	if (FMessageDialog::Open(EAppMsgType::YesNo, Message) == EAppReturnType::No)
 	{
@@ -400,7 +741,7 @@ bool FRiderSourceCodeAccessor::TryGenerateSolutionFile() const
 
 TOptional<FString> FRiderSourceCodeAccessor::GetSolutionPath() const
 {
-	FScopeLock Lock(&CachedSolutionPathCriticalSection);
+	FSolutionPathScopeLock Lock(*this);
 
 	CachePathToSolution();
 
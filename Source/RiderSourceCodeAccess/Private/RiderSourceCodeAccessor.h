@@ -28,6 +28,21 @@ public:
 	
 	void Init(const FInstallInfo& Info, EProjectModel ProjectModel, EAccessType Type = EAccessType::Direct);
 
+	/** Name Init gives an accessor for the install, available without creating one */
+	static FName MakeName(const FInstallInfo& Info, EProjectModel ProjectModel, EAccessType Type);
+
+	/**
+	 * Starts Rider with the solution below normal priority, later open requests are forwarded to that instance.
+	 * Does nothing if Rider is already running or there is no solution yet.
+	 */
+	bool Prelaunch();
+
+	/**
+	 * Opens the declaration of a reflected type or function, e.g. "AActor" or "AActor::BeginPlay". Must be called on the game thread.
+	 * The first call starts building the symbol index, calls fail until it is loaded
+	 */
+	bool OpenSymbol(const FString& SymbolName);
+
 	/** ISourceCodeAccessor implementation */
 	virtual void RefreshAvailability() override;
 	virtual bool CanAccessSourceCode() const override;
@@ -43,30 +58,67 @@ public:
 	virtual bool SaveAllOpenDocuments() const override;
 	virtual void Tick(const float) override {}
 private:
+	friend class FRiderSourceCodeAccessorBenchmark;
+
+	static TOptional<FString> GetOpenFileAtLineParams(const FString& SolutionPath, const FString& FullPath, int32 LineNumber);
+	static TOptional<FString> GetOpenSourceFilesParams(const FString& SolutionPath, const TArray<FString>& AbsoluteSourcePaths);
+	static TOptional<FString> GetLightEditParams(const TArray<FString>& AbsoluteSourcePaths, int32 LineNumber = INDEX_NONE);
+
+	/** Whether files should open in LightEdit instead of waiting for a solution to load */
+	bool ShouldOpenLightEdit() const;
+	bool OpenLightEdit(const TArray<FString>& AbsoluteSourcePaths, int32 LineNumber = INDEX_NONE);
+
 	void CachePathToUproject() const;
 	void CachePathToSln() const;
 	void CachePathToSolution() const;
+	static bool HasCodeModules();
 	bool TryGenerateSlnFile() const;
 	bool HandleOpeningRider(TFunction<bool()> Callback) const;
 
 	bool TryGenerateSolutionFile() const;
 	TOptional<FString> GetSolutionPath() const;
 
+	/** Returns CachedSolutionPath, refreshed first on the game thread and resolved on first use elsewhere */
+	FString GetCachedSolutionPath() const;
+
+	struct FLaunchers
+	{
+		FString ExecutablePath;
+		FString FallbackExecutablePath;
+
+		/** Whether a process of this install is running, whichever launcher started it */
+		bool IsInstallRunning() const;
+	};
+	FLaunchers GetLaunchers() const;
+
+	/** Locks CachedSolutionPathCriticalSection, adding the time spent waiting for it to SolutionPathContentionCycles */
+	class FSolutionPathScopeLock;
+
 	FName RiderName;
 
 	/** Is Rider installed on this system? */
-	bool bHasRiderInstalled = false;
+	TAtomic<bool> bHasRiderInstalled { false };
 	
+	/** Guards ExecutablePath and FallbackExecutablePath, which Init and RefreshAvailability can change while other threads open files */
+	mutable FRWLock LaunchersLock;
+
 	/** The path to the Rider executable. */
 	FString ExecutablePath;
 
+	/** Script launcher used when the native ExecutablePath can't be started, empty if ExecutablePath is the script */
+	FString FallbackExecutablePath;
+
 	/** Critical section for updating SolutionPath */
 	mutable FCriticalSection CachedSolutionPathCriticalSection;
+	mutable TAtomic<uint64> SolutionPathContentionCycles { 0 };
 
-	/** String storing the solution path obtained from the module manager to avoid having to use it on a thread */
+	/** Solution path, recomputed on the game thread and only resolved once when it was first needed on another thread */
 	mutable FString CachedSolutionPath = {};
 
 	/** Override for the cached solution path */
 	mutable FString CachedSolutionPathOverride = {};
 	EProjectModel Model = EProjectModel::Sln;
+
+	/** Set by the first LightEdit open, the solution is loaded behind it only once */
+	TAtomic<bool> bLightEditUpgradeScheduled { false };
 };
@@ -0,0 +1,457 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderSourceCodeAccessor.h"
+
+#include "RiderCallTrace.h"
+#include "RiderInstanceRouter.h"
+#include "RiderPathLocator/RiderPathLocator.h"
+#include "RiderRemoteTransport.h"
+#include "RiderSourceCodeAccessSettings.h"
+
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRiderBenchmark, Log, All);
+
+/**
+ * Drives a stub-launcher-backed accessor at a high request rate.
+ * Usage: Rider.Benchmark.Launch [NumRequests=200] [StubLauncherPath]
+ * Without a stub path a recording bin/rider and a bin/rider.sh wrapper are generated (Linux and Mac only),
+ * and both launch paths are measured.
+ * The stub must append "<unix time in seconds> <args>" to the file named by RIDER_STUB_LOG.
+ * Every run uses its own routes file and ignores the RemoteHost and LightEdit settings, so it never reaches a real Rider.
+ *
+ * Rider.Benchmark.Concurrency [NumThreads=8] [RequestsPerThread=100] [StubLauncherPath] first checks that accessors
+ * initialized on a worker resolve the same solution as on the game thread, then drives one accessor from many threads.
+ * Runs headless, e.g. UnrealEditor-Cmd <Project> -unattended -nullrhi -ExecCmds="Rider.Benchmark.Concurrency 16 200, Quit"
+ * Build the editor with UBT's -EnableTSan on Linux to run it under ThreadSanitizer.
+ *
+ * Rider.Benchmark.Replay <TracePath> [Speed=1] [StubLauncherPath] replays a trace recorded with Rider.Trace.Start or
+ * CallTracePath. Speed scales the recorded pacing, 0 issues the calls back to back.
+ */
+class FRiderSourceCodeAccessorBenchmark
+{
+public:
+	static void Run(int32 NumRequests, const FString& InStubLauncherPath)
+	{
+		const FString Root = FPaths::Combine(FPlatformProcess::UserTempDir(), TEXT("RiderLaunchBenchmark"), FGuid::NewGuid().ToString());
+		const FIsolatedRun IsolatedRun(Root);
+		if (!InStubLauncherPath.IsEmpty())
+		{
+			RunWithLauncher(TEXT("Custom stub"), FInstallInfo(InStubLauncherPath, FInstallInfo::EInstallType::Custom), NumRequests, Root);
+		}
+		else
+		{
+			const TOptional<FInstallInfo> StubInfo = GenerateStubLaunchers(Root);
+			if (!StubInfo.IsSet())
+			{
+				UE_LOG(LogRiderBenchmark, Error, TEXT("No stub launcher available, pass its path as the second argument"));
+				return;
+			}
+
+			// Same stub reached directly and through the wrapper script, the difference is what a launch saves
+			FInstallInfo ScriptInfo = StubInfo.GetValue();
+			ScriptInfo.NativeLauncherPath.Empty();
+			RunWithLauncher(TEXT("Native launcher"), StubInfo.GetValue(), NumRequests, Root);
+			RunWithLauncher(TEXT("Script wrapper"), ScriptInfo, NumRequests, Root);
+		}
+		IFileManager::Get().DeleteDirectory(*Root, false, true);
+	}
+
+	static void RunConcurrent(int32 NumThreads, int32 RequestsPerThread, const FString& InStubLauncherPath)
+	{
+		const FString Root = FPaths::Combine(FPlatformProcess::UserTempDir(), TEXT("RiderLaunchBenchmark"), FGuid::NewGuid().ToString());
+		const FIsolatedRun IsolatedRun(Root);
+		const TOptional<FInstallInfo> StubInfo = InStubLauncherPath.IsEmpty()
+			? GenerateStubLaunchers(Root)
+			: TOptional<FInstallInfo>(FInstallInfo(InStubLauncherPath, FInstallInfo::EInstallType::Custom));
+		if (!StubInfo.IsSet())
+		{
+			UE_LOG(LogRiderBenchmark, Error, TEXT("No stub launcher available, pass its path as the third argument"));
+			return;
+		}
+		const FString LogPath = FPaths::Combine(Root, TEXT("Concurrency.log"));
+		FPlatformMisc::SetEnvironmentVar(TEXT("RIDER_STUB_LOG"), *LogPath);
+
+		// Deferred accessors are created by whichever thread uses them first, a worker has to see the same solution the game thread does
+		for (const FRiderSourceCodeAccessor::EProjectModel Model : { FRiderSourceCodeAccessor::EProjectModel::Sln, FRiderSourceCodeAccessor::EProjectModel::Uproject })
+		{
+			FRiderSourceCodeAccessor GameThreadAccessor;
+			GameThreadAccessor.Init(StubInfo.GetValue(), Model);
+			const FString ExpectedSolutionPath = GameThreadAccessor.GetCachedSolutionPath();
+
+			struct FColdResult
+			{
+				FString SolutionPath;
+				bool bSolutionExists = false;
+				double Seconds = 0.0;
+			};
+			const FColdResult Cold = Async(EAsyncExecution::Thread, [&StubInfo, Model]()
+			{
+				FColdResult Result;
+				const double ColdStartTime = FPlatformTime::Seconds();
+				FRiderSourceCodeAccessor ColdAccessor;
+				ColdAccessor.Init(StubInfo.GetValue(), Model);
+				Result.bSolutionExists = ColdAccessor.DoesSolutionExist();
+				Result.Seconds = FPlatformTime::Seconds() - ColdStartTime;
+				Result.SolutionPath = ColdAccessor.GetCachedSolutionPath();
+				return Result;
+			}).Get();
+
+			const TCHAR* ModelName = Model == FRiderSourceCodeAccessor::EProjectModel::Sln ? TEXT("Sln") : TEXT("Uproject");
+			if (Cold.SolutionPath != ExpectedSolutionPath || Cold.bSolutionExists != FPaths::FileExists(ExpectedSolutionPath))
+			{
+				UE_LOG(LogRiderBenchmark, Error, TEXT("%s accessor first used on a worker resolved \"%s\", the game thread resolves \"%s\""),
+					ModelName, *Cold.SolutionPath, *ExpectedSolutionPath);
+			}
+			else
+			{
+				UE_LOG(LogRiderBenchmark, Display, TEXT("%s accessor first used on a worker: Init and DoesSolutionExist took %.3f ms"), ModelName, Cold.Seconds * 1000.0);
+			}
+		}
+
+		// Init runs on the game thread like in the editor, everything after it is what parallel tooling would call
+		FRiderSourceCodeAccessor Accessor;
+		Accessor.Init(StubInfo.GetValue(), FRiderSourceCodeAccessor::EProjectModel::Uproject);
+
+		const FString SourceFile = FPaths::Combine(FPaths::EngineSourceDir(), TEXT("Runtime"), TEXT("Core"), TEXT("Public"), TEXT("CoreMinimal.h"));
+		const TArray<FString> SourceFiles = { SourceFile, SourceFile };
+
+		struct FThreadResult
+		{
+			TArray<double> OpenSeconds;
+			TArray<double> QuerySeconds;
+			int32 NumFailed = 0;
+		};
+		TArray<TFuture<FThreadResult>> Futures;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 ThreadIndex = 0; ThreadIndex < NumThreads; ThreadIndex++)
+		{
+			Futures.Add(Async(EAsyncExecution::Thread, [&Accessor, &SourceFile, &SourceFiles, RequestsPerThread, ThreadIndex]()
+			{
+				FThreadResult Result;
+				for (int32 Index = 0; Index < RequestsPerThread; Index++)
+				{
+					const double CallStartTime = FPlatformTime::Seconds();
+					bool bSucceeded = true;
+					switch ((Index + ThreadIndex) % 4)
+					{
+						case 0: bSucceeded = Accessor.OpenFileAtLine(SourceFile, Index); break;
+						case 1: bSucceeded = Accessor.OpenSourceFiles(SourceFiles); break;
+						case 2: bSucceeded = Accessor.DoesSolutionExist(); break;
+						default: Accessor.RefreshAvailability(); break;
+					}
+					((Index + ThreadIndex) % 4 < 2 ? Result.OpenSeconds : Result.QuerySeconds).Add(FPlatformTime::Seconds() - CallStartTime);
+					Result.NumFailed += bSucceeded ? 0 : 1;
+				}
+				return Result;
+			}));
+		}
+
+		FThreadResult Total;
+		for (TFuture<FThreadResult>& Future : Futures)
+		{
+			FThreadResult Result = Future.Get();
+			Total.OpenSeconds.Append(Result.OpenSeconds);
+			Total.QuerySeconds.Append(Result.QuerySeconds);
+			Total.NumFailed += Result.NumFailed;
+		}
+		const double TotalSeconds = FPlatformTime::Seconds() - StartTime;
+		const int32 NumRequests = NumThreads * RequestsPerThread;
+
+		UE_LOG(LogRiderBenchmark, Display, TEXT("%d threads, %d requests in %.3f s: %.1f requests/s, %d failed"),
+			NumThreads, NumRequests, TotalSeconds, NumRequests / FMath::Max(TotalSeconds, SMALL_NUMBER), Total.NumFailed);
+		UE_LOG(LogRiderBenchmark, Display, TEXT("  Waiting for the solution path lock: %.3f ms in total"),
+			FPlatformTime::ToMilliseconds64(Accessor.SolutionPathContentionCycles.Load()));
+		Report(TEXT("Open call"), Total.OpenSeconds);
+		Report(TEXT("Query call"), Total.QuerySeconds);
+
+		// Launches from different threads interleave, so only their number is checked
+		TArray<double> OpenCallTimestamps;
+		OpenCallTimestamps.SetNumZeroed(Total.OpenSeconds.Num());
+		const int32 NumLaunches = CollectLaunchLatencies(LogPath, OpenCallTimestamps).Num();
+		UE_LOG(LogRiderBenchmark, Display, TEXT("  Stub launcher recorded %d launches for %d open calls"), NumLaunches, Total.OpenSeconds.Num());
+		IFileManager::Get().DeleteDirectory(*Root, false, true);
+	}
+
+	static void RunReplay(const FString& TracePath, double Speed, const FString& InStubLauncherPath)
+	{
+		using ECall = FRiderCallTrace::ECall;
+
+		const TOptional<TArray<FRiderCallTrace::FCall>> Calls = FRiderCallTrace::Load(TracePath);
+		if (!Calls.IsSet())
+		{
+			UE_LOG(LogRiderBenchmark, Error, TEXT("Couldn't read the call trace %s"), *TracePath);
+			return;
+		}
+
+		const FString Root = FPaths::Combine(FPlatformProcess::UserTempDir(), TEXT("RiderLaunchBenchmark"), FGuid::NewGuid().ToString());
+		const FIsolatedRun IsolatedRun(Root);
+		const TOptional<FInstallInfo> StubInfo = InStubLauncherPath.IsEmpty()
+			? GenerateStubLaunchers(Root)
+			: TOptional<FInstallInfo>(FInstallInfo(InStubLauncherPath, FInstallInfo::EInstallType::Custom));
+		if (!StubInfo.IsSet())
+		{
+			UE_LOG(LogRiderBenchmark, Error, TEXT("No stub launcher available, pass its path as the third argument"));
+			return;
+		}
+		const FString LogPath = FPaths::Combine(Root, TEXT("Replay.log"));
+		FPlatformMisc::SetEnvironmentVar(TEXT("RIDER_STUB_LOG"), *LogPath);
+
+		FRiderSourceCodeAccessor Accessor;
+		Accessor.Init(StubInfo.GetValue(), FRiderSourceCodeAccessor::EProjectModel::Uproject);
+
+		TArray<TArray<double>> CallSeconds;
+		CallSeconds.SetNum(static_cast<int32>(ECall::Num));
+		TArray<double> OpenCallTimestamps;
+		double MaxLagSeconds = 0.0;
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (const FRiderCallTrace::FCall& Call : Calls.GetValue())
+		{
+			// Late calls are issued right away, how far behind the schedule they ran is reported below
+			if (Speed > 0.0)
+			{
+				const double DueTime = StartTime + Call.Seconds / Speed;
+				const double Now = FPlatformTime::Seconds();
+				if (DueTime > Now)
+				{
+					FPlatformProcess::Sleep(static_cast<float>(DueTime - Now));
+				}
+				else
+				{
+					MaxLagSeconds = FMath::Max(MaxLagSeconds, Now - DueTime);
+				}
+			}
+
+			const bool bOpens = Call.Call == ECall::OpenFileAtLine || Call.Call == ECall::OpenSourceFiles || Call.Call == ECall::OpenSolution;
+			if (bOpens)
+			{
+				OpenCallTimestamps.Add(GetUnixTimestamp());
+			}
+			const double CallStartTime = FPlatformTime::Seconds();
+			switch (Call.Call)
+			{
+				case ECall::OpenFileAtLine: Accessor.OpenFileAtLine(Call.Paths[0], Call.Line, Call.Column); break;
+				case ECall::OpenSourceFiles: Accessor.OpenSourceFiles(Call.Paths); break;
+				case ECall::OpenSolution: Accessor.OpenSolution(); break;
+				case ECall::DoesSolutionExist: Accessor.DoesSolutionExist(); break;
+				default: Accessor.AddSourceFiles(Call.Paths, Call.Modules); break;
+			}
+			CallSeconds[static_cast<int32>(Call.Call)].Add(FPlatformTime::Seconds() - CallStartTime);
+		}
+		const double TotalSeconds = FPlatformTime::Seconds() - StartTime;
+		const double RecordedSeconds = Calls->Num() > 0 ? Calls->Last().Seconds : 0.0;
+
+		UE_LOG(LogRiderBenchmark, Display, TEXT("Replayed %d calls recorded over %.3f s in %.3f s, at most %.3f ms behind schedule"),
+			Calls->Num(), RecordedSeconds, TotalSeconds, MaxLagSeconds * 1000.0);
+		for (int32 Index = 0; Index < CallSeconds.Num(); Index++)
+		{
+			if (CallSeconds[Index].Num() == 0) continue;
+
+			const FString Label = FString::Printf(TEXT("%s x%d"), FRiderCallTrace::GetCallName(static_cast<ECall>(Index)), CallSeconds[Index].Num());
+			Report(*Label, CallSeconds[Index]);
+		}
+
+		// Launches are matched to calls in order, which only holds when every open call launched exactly once
+		TArray<double> LaunchSeconds = CollectLaunchLatencies(LogPath, OpenCallTimestamps);
+		UE_LOG(LogRiderBenchmark, Display, TEXT("  Stub launcher recorded %d launches for %d open calls"), LaunchSeconds.Num(), OpenCallTimestamps.Num());
+		if (LaunchSeconds.Num() == OpenCallTimestamps.Num())
+		{
+			Report(TEXT("Call to stub launch"), LaunchSeconds);
+		}
+		IFileManager::Get().DeleteDirectory(*Root, false, true);
+	}
+
+private:
+	/** Keeps a run away from the user's IDE: routes of other editors, the remote host and LightEdit opens don't apply */
+	class FIsolatedRun
+	{
+	public:
+		explicit FIsolatedRun(const FString& Root)
+		{
+			FRiderInstanceRouter::SetRoutesPathOverride(FPaths::Combine(Root, TEXT("Routes.json")));
+			FRiderRemoteTransport::SetSuspended(true);
+
+			FRiderSourceCodeAccessSettings Settings = FRiderSourceCodeAccessSettings::Get();
+			Settings.RemoteHost.Empty();
+			Settings.RemotePathMap.Empty();
+			Settings.bLightEditFileOpens = false;
+			FRiderSourceCodeAccessSettings::SetOverride(Settings);
+		}
+
+		~FIsolatedRun()
+		{
+			FRiderSourceCodeAccessSettings::SetOverride({});
+			FRiderRemoteTransport::SetSuspended(false);
+			FRiderInstanceRouter::SetRoutesPathOverride(FString());
+		}
+	};
+
+	static void RunWithLauncher(const TCHAR* Label, const FInstallInfo& StubInfo, int32 NumRequests, const FString& Root)
+	{
+		const FString LogPath = FPaths::Combine(Root, FString(Label).Replace(TEXT(" "), TEXT("")) + TEXT(".log"));
+		FPlatformMisc::SetEnvironmentVar(TEXT("RIDER_STUB_LOG"), *LogPath);
+
+		FRiderSourceCodeAccessor Accessor;
+		Accessor.Init(StubInfo, FRiderSourceCodeAccessor::EProjectModel::Uproject);
+
+		const FString SolutionPath = FPaths::GetProjectFilePath();
+		const FString SourceFile = FPaths::Combine(FPaths::EngineSourceDir(), TEXT("Runtime"), TEXT("Core"), TEXT("Public"), TEXT("CoreMinimal.h"));
+		const TArray<FString> SourceFiles = { SourceFile, SourceFile, SourceFile };
+
+		TArray<double> ArgumentSeconds;
+		TArray<double> CallSeconds;
+		TArray<double> CallStartTimestamps;
+		ArgumentSeconds.Reserve(NumRequests);
+		CallSeconds.Reserve(NumRequests);
+		CallStartTimestamps.Reserve(NumRequests);
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumRequests; Index++)
+		{
+			double ArgumentStartTime = FPlatformTime::Seconds();
+			if (Index % 3 == 1)
+			{
+				FRiderSourceCodeAccessor::GetOpenSourceFilesParams(SolutionPath, SourceFiles);
+			}
+			else if (Index % 3 == 0)
+			{
+				FRiderSourceCodeAccessor::GetOpenFileAtLineParams(SolutionPath, SourceFile, Index);
+			}
+			ArgumentSeconds.Add(FPlatformTime::Seconds() - ArgumentStartTime);
+
+			CallStartTimestamps.Add(GetUnixTimestamp());
+			const double CallStartTime = FPlatformTime::Seconds();
+			switch (Index % 3)
+			{
+				case 0: Accessor.OpenFileAtLine(SourceFile, Index); break;
+				case 1: Accessor.OpenSourceFiles(SourceFiles); break;
+				default: Accessor.OpenSolution(); break;
+			}
+			CallSeconds.Add(FPlatformTime::Seconds() - CallStartTime);
+		}
+		const double TotalSeconds = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogRiderBenchmark, Display, TEXT("%s: %d requests in %.3f s: %.1f requests/s"), Label, NumRequests, TotalSeconds, NumRequests / FMath::Max(TotalSeconds, SMALL_NUMBER));
+		Report(TEXT("Argument building"), ArgumentSeconds);
+		Report(TEXT("Accessor call"), CallSeconds);
+
+		TArray<double> LaunchSeconds = CollectLaunchLatencies(LogPath, CallStartTimestamps);
+		if (LaunchSeconds.Num() != NumRequests)
+		{
+			UE_LOG(LogRiderBenchmark, Warning, TEXT("Stub launcher recorded %d of %d launches"), LaunchSeconds.Num(), NumRequests);
+		}
+		Report(TEXT("Call to stub launch"), LaunchSeconds);
+	}
+
+	static double GetUnixTimestamp()
+	{
+		return (FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTotalSeconds();
+	}
+
+	/** A recording bin/rider and a bin/rider.sh wrapper that execs it, laid out like a Linux install */
+	static TOptional<FInstallInfo> GenerateStubLaunchers(const FString& Root)
+	{
+#if PLATFORM_WINDOWS
+		return {};
+#else
+		const FString NativeLauncherPath = FPaths::Combine(Root, TEXT("bin"), TEXT("rider"));
+		const FString ScriptLauncherPath = FPaths::Combine(Root, TEXT("bin"), TEXT("rider.sh"));
+		// date has no sub-second format on Mac, perl's Time::HiRes is there on both
+		const FString NativeScript = TEXT("#!/bin/sh\nNow=$(date +%s.%N)\ncase \"$Now\" in *N) Now=$(perl -MTime::HiRes=time -e 'printf \"%.6f\", time') ;; esac\necho \"$Now $*\" >> \"$RIDER_STUB_LOG\"\n");
+		const FString WrapperScript = TEXT("#!/bin/bash\nexec \"$(dirname \"$0\")/rider\" \"$@\"\n");
+		if (!FFileHelper::SaveStringToFile(NativeScript, *NativeLauncherPath) || !FFileHelper::SaveStringToFile(WrapperScript, *ScriptLauncherPath)) return {};
+
+		int32 ReturnCode = 0;
+		FPlatformProcess::ExecProcess(TEXT("/bin/chmod"), *FString::Printf(TEXT("+x \"%s\" \"%s\""), *NativeLauncherPath, *ScriptLauncherPath), &ReturnCode, nullptr, nullptr);
+		if (ReturnCode != 0) return {};
+
+		FInstallInfo StubInfo(ScriptLauncherPath, FInstallInfo::EInstallType::Custom);
+		StubInfo.NativeLauncherPath = NativeLauncherPath;
+		return StubInfo;
+#endif
+	}
+
+	/** Stub launches are detached, so wait for them to land in the log and match them to calls in order */
+	static TArray<double> CollectLaunchLatencies(const FString& LogPath, const TArray<double>& CallStartTimestamps)
+	{
+		TArray<FString> Lines;
+		const double Deadline = FPlatformTime::Seconds() + 10.0;
+		while (FPlatformTime::Seconds() < Deadline)
+		{
+			Lines.Reset();
+			FFileHelper::LoadFileToStringArray(Lines, *LogPath);
+			if (Lines.Num() >= CallStartTimestamps.Num()) break;
+			FPlatformProcess::Sleep(0.05f);
+		}
+
+		TArray<double> LaunchTimestamps;
+		for (const FString& Line : Lines)
+		{
+			LaunchTimestamps.Add(FCString::Atod(*Line));
+		}
+		LaunchTimestamps.Sort();
+
+		TArray<double> Result;
+		const int32 Num = FMath::Min(LaunchTimestamps.Num(), CallStartTimestamps.Num());
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Result.Add(LaunchTimestamps[Index] - CallStartTimestamps[Index]);
+		}
+		return Result;
+	}
+
+	static void Report(const TCHAR* Name, TArray<double> Seconds)
+	{
+		if (Seconds.Num() == 0) return;
+
+		Seconds.Sort();
+		const auto Percentile = [&Seconds](double Fraction) { return Seconds[FMath::Min(FMath::FloorToInt(Fraction * Seconds.Num()), Seconds.Num() - 1)] * 1000.0; };
+		UE_LOG(LogRiderBenchmark, Display, TEXT("  %-20s p50 %8.3f ms, p90 %8.3f ms, p99 %8.3f ms, max %8.3f ms"),
+			Name, Percentile(0.5), Percentile(0.9), Percentile(0.99), Seconds.Last() * 1000.0);
+	}
+};
+
+static FAutoConsoleCommand RiderLaunchBenchmarkCommand(
+	TEXT("Rider.Benchmark.Launch"),
+	TEXT("Drives OpenFileAtLine/OpenSourceFiles/OpenSolution against a stub launcher. Args: [NumRequests=200] [StubLauncherPath]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumRequests = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 200;
+		const FString StubLauncherPath = Args.Num() > 1 ? Args[1] : FString();
+		FRiderSourceCodeAccessorBenchmark::Run(NumRequests, StubLauncherPath);
+	}));
+
+static FAutoConsoleCommand RiderConcurrencyBenchmarkCommand(
+	TEXT("Rider.Benchmark.Concurrency"),
+	TEXT("Calls OpenFileAtLine/OpenSourceFiles/DoesSolutionExist/RefreshAvailability on one accessor from many threads. Args: [NumThreads=8] [RequestsPerThread=100] [StubLauncherPath]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumThreads = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 1, 256) : 8;
+		const int32 RequestsPerThread = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 100;
+		const FString StubLauncherPath = Args.Num() > 2 ? Args[2] : FString();
+		FRiderSourceCodeAccessorBenchmark::RunConcurrent(NumThreads, RequestsPerThread, StubLauncherPath);
+	}));
+
+static FAutoConsoleCommand RiderReplayBenchmarkCommand(
+	TEXT("Rider.Benchmark.Replay"),
+	TEXT("Replays a recorded call trace against a stub launcher. Args: <TracePath> [Speed=1, 0 for back to back] [StubLauncherPath]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() == 0)
+		{
+			UE_LOG(LogRiderBenchmark, Error, TEXT("Pass the trace to replay"));
+			return;
+		}
+		const double Speed = Args.Num() > 1 ? FMath::Max(FCString::Atod(*Args[1]), 0.0) : 1.0;
+		const FString StubLauncherPath = Args.Num() > 2 ? Args[2] : FString();
+		FRiderSourceCodeAccessorBenchmark::RunReplay(Args[0], Speed, StubLauncherPath);
+	}));
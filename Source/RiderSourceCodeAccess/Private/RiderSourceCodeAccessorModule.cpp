@@ -2,22 +2,396 @@
 
 #include "RiderSourceCodeAccessorModule.h"
 
+#include "RiderPathLocator/RiderInstallCache.h"
 #include "RiderPathLocator/RiderPathLocator.h"
+#include "RiderCallTrace.h"
+#include "RiderDeferredSourceCodeAccessor.h"
+#include "RiderPathCaseIndex.h"
+#include "RiderProjectModelExporter.h"
+#include "RiderReloadHandover.h"
+#include "RiderRemoteTransport.h"
 #include "RiderSourceCodeAccessor.h"
+#include "RiderSourceCodeAccessSettings.h"
+#include "RiderSourcePathIndex.h"
+#include "RiderSourceTree.h"
+#include "RiderSymbolIndex.h"
 
+#include "CoreGlobals.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 #include "Modules/ModuleManager.h"
 #include "Features/IModularFeatures.h"
 
 #define LOCTEXT_NAMESPACE "RiderSourceCodeAccessor"
 
+DEFINE_LOG_CATEGORY_STATIC(LogRiderSourceCodeAccess, Log, All);
+
 IMPLEMENT_MODULE(FRiderSourceCodeAccessModule, RiderSourceCodeAccess);
 
+/** Bumped whenever the handover blob layout changes, a reload into a different layout starts cold */
+static const int32 ReloadHandoverVersion = 1;
+
 void FRiderSourceCodeAccessModule::StartupModule()
 {
-	TArray<FInstallInfo> InstallInfos = FRiderPathLocator::CollectAllPaths().Array();
+	const double StartTime = FPlatformTime::Seconds();
+	HandedOverSourceFiles = RestoreReloadHandover();
+	FRiderCallTrace::Initialize();
+	FRiderRemoteTransport::Initialize();
+	bDeferredDiscovery = ShouldDeferDiscovery();
+
+	// Deferred processes only pay for what an accessor call actually needs, the indexes start along with discovery
+	if (bDeferredDiscovery)
+	{
+		GenerateDeferredAccessors();
+	}
+	else
+	{
+		GenerateAccessors(GetInstallInfos());
+		StartSourceIndexes();
+		if (FRiderSourceCodeAccessSettings::Get().bExportProjectModel)
+		{
+			FRiderProjectModelExporter::Initialize([this]() { return IsUprojectModelSelected(); });
+		}
+		if (FRiderSourceCodeAccessSettings::Get().bPrelaunchIDE)
+		{
+			PrelaunchHandle = FCoreDelegates::OnFEngineLoopInitComplete.AddRaw(this, &FRiderSourceCodeAccessModule::PrelaunchIDE);
+		}
+	}
+
+	// Removes itself once discovery completed, deferred discovery may only start long after startup
+	PendingDiscoveryTickerHandle = FRiderTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FRiderSourceCodeAccessModule::TickPendingDiscovery), 0.5f);
+	UE_LOG(LogRiderSourceCodeAccess, Log, TEXT("Startup took %.2f ms (%s discovery)"),
+		(FPlatformTime::Seconds() - StartTime) * 1000.0, bDeferredDiscovery ? TEXT("deferred") : TEXT("eager"));
+}
+
+void FRiderSourceCodeAccessModule::StartSourceIndexes()
+{
+	check(IsInGameThread());
+	if (bSourceIndexesStarted) return;
+
+	bSourceIndexesStarted = true;
+	FRiderSourcePathIndex::Initialize(MoveTemp(HandedOverSourceFiles));
+	FRiderPathCaseIndex::Initialize();
+}
+
+void FRiderSourceCodeAccessModule::RequestSourceIndexes()
+{
+	if (IsInGameThread())
+	{
+		StartSourceIndexes();
+		return;
+	}
+
+	// The module may be gone by the time the game thread gets to it
+	AsyncTask(ENamedThreads::GameThread, []()
+	{
+		if (FRiderSourceCodeAccessModule* Module = FModuleManager::GetModulePtr<FRiderSourceCodeAccessModule>(TEXT("RiderSourceCodeAccess")))
+		{
+			Module->StartSourceIndexes();
+		}
+	});
+}
+
+bool FRiderSourceCodeAccessModule::ShouldDeferDiscovery()
+{
+	// Processes that can't show an IDE to anyone only need discovery if something asks for an install
+	return FRiderSourceCodeAccessSettings::Get().bDeferDiscovery || FApp::IsUnattended() || IsRunningCommandlet() || !FApp::CanEverRender();
+}
+
+TArray<FInstallInfo> FRiderSourceCodeAccessModule::GetInstallInfos()
+{
+	FScopeLock Lock(&InstallInfosCriticalSection);
+	if (!InstallInfosCache.IsSet())
+	{
+		// Waiting for another process' discovery is bounded like running our own
+		const FRiderSourceCodeAccessSettings Settings = FRiderSourceCodeAccessSettings::Get();
+		const double WaitSeconds = Settings.DiscoveryTimeBudgetSeconds > 0.0f ? Settings.DiscoveryTimeBudgetSeconds : 30.0;
+		TArray<FInstallInfo> InstallInfos = FRiderInstallCache::LoadOrCollect(Settings.InstallCacheLifetimeSeconds, WaitSeconds, [this](bool& bOutComplete)
+		{
+			return CollectInstallInfos(bOutComplete);
+		});
+		InstallInfos.Sort();
+		InstallInfosCache = MoveTemp(InstallInfos);
+	}
+	return InstallInfosCache.GetValue();
+}
+
+TArray<FInstallInfo> FRiderSourceCodeAccessModule::CollectInstallInfos(bool& bOutComplete)
+{
+	const float TimeBudgetSeconds = FRiderSourceCodeAccessSettings::Get().DiscoveryTimeBudgetSeconds;
+	if (TimeBudgetSeconds <= 0.0f)
+	{
+		return FRiderPathLocator::CollectAllPaths().Array();
+	}
+
+	FBudgetedDiscoveryResult Result = FRiderPathLocator::CollectAllPathsWithinBudget(TimeBudgetSeconds);
+	bOutComplete = Result.IsComplete();
+	if (!bOutComplete)
+	{
+		UE_LOG(LogRiderSourceCodeAccess, Log, TEXT("Rider discovery exceeded its %.1f s budget, continuing in the background with %d installs found so far"),
+			TimeBudgetSeconds, Result.InstallInfos.Num());
+		// Published as soon as it completes, processes waiting for it shouldn't depend on this one ticking
+		PendingDiscovery = Result.Remaining.Next([](TSet<FInstallInfo> InstallInfos)
+		{
+			if (FRiderSourceCodeAccessSettings::Get().InstallCacheLifetimeSeconds > 0)
+			{
+				TArray<FInstallInfo> SortedInstallInfos = InstallInfos.Array();
+				SortedInstallInfos.Sort();
+				FRiderInstallCache::Publish(SortedInstallInfos);
+			}
+			return InstallInfos;
+		});
+	}
+	return Result.InstallInfos.Array();
+}
+
+bool FRiderSourceCodeAccessModule::TickPendingDiscovery(float)
+{
+	TArray<FInstallInfo> InstallInfos;
+	bool bDiscoveryCompleted = false;
+	{
+		FScopeLock Lock(&InstallInfosCriticalSection);
+		if (PendingDiscovery.IsValid())
+		{
+			if (!PendingDiscovery.IsReady()) return true;
+
+			InstallInfos = PendingDiscovery.Get().Array();
+			PendingDiscovery.Reset();
+			InstallInfos.Sort();
+			InstallInfosCache = InstallInfos;
+			bDiscoveryCompleted = true;
+		}
+		else if (!InstallInfosCache.IsSet())
+		{
+			return true;
+		}
+	}
+
+	// Deferred accessors resolve from the complete list on next use and are renamed if it names them differently,
+	// eagerly listed ones are regenerated from it
+	if (bDeferredDiscovery)
+	{
+		if (bDiscoveryCompleted)
+		{
+			for (const TPair<FString, TSharedRef<FRiderDeferredSourceCodeAccessor>>& Accessor : RiderSourceCodeAccessors)
+			{
+				Accessor.Value->InvalidateInstalls();
+			}
+		}
+		GenerateDeferredAccessors();
+	}
+	else if (bDiscoveryCompleted)
+	{
+		GenerateAccessors(InstallInfos);
+	}
+	PendingDiscoveryTickerHandle.Reset();
+	return false;
+}
+
+TArray<FInstallInfo> FRiderSourceCodeAccessModule::WithRemoteFallback(TArray<FInstallInfo>&& InstallInfos)
+{
+	// Editors on build servers usually have no Rider of their own, the remote host stands in for one
+	if (InstallInfos.Num() == 0 && FRiderRemoteTransport::Get() != nullptr)
+	{
+		FInstallInfo RemoteInfo(FRiderRemoteTransport::Get()->GetHostName(), FInstallInfo::EInstallType::Custom);
+		RemoteInfo.SupportUprojectState = FInstallInfo::ESupportUproject::Release;
+		return { RemoteInfo };
+	}
+	return MoveTemp(InstallInfos);
+}
+
+void FRiderSourceCodeAccessModule::GenerateAccessors(const TArray<FInstallInfo>& InstallInfos)
+{
+	FAccessorMap Accessors;
+	const TArray<FInstallInfo> AccessorInstallInfos = WithRemoteFallback(CopyTemp(InstallInfos));
+	GenerateUprojectAccessors(AccessorInstallInfos, Accessors);
+	GenerateSlnAccessors(AccessorInstallInfos, Accessors);
+	ApplyAccessors(MoveTemp(Accessors));
+}
+
+void FRiderSourceCodeAccessModule::GenerateDeferredAccessors()
+{
+	// Named after the installs a previous run or module instance found, the same names GenerateAccessors gives them,
+	// so the editor's preferred accessor carries over between modes. TickPendingDiscovery renames them if discovery disagrees
+	const TArray<FInstallInfo> KnownInstallInfos = WithRemoteFallback(GetKnownInstallInfos());
+
+	FAccessorMap Accessors;
+	const FName UprojectName = MakeAggregateName(FilterUprojectInstalls(KnownInstallInfos), FRiderSourceCodeAccessor::EProjectModel::Uproject);
+	Accessors.Add(UprojectName.ToString(), MakeShared<FRiderDeferredSourceCodeAccessor>(UprojectName, FRiderSourceCodeAccessor::EProjectModel::Uproject,
+		FRiderSourceCodeAccessor::EAccessType::Aggregate, [this]()
+		{
+			RequestSourceIndexes();
+			return WithRemoteFallback(FilterUprojectInstalls(GetInstallInfos()));
+		}));
+
+#if PLATFORM_WINDOWS
+	const FName SlnName = MakeAggregateName(KnownInstallInfos, FRiderSourceCodeAccessor::EProjectModel::Sln);
+	Accessors.Add(SlnName.ToString(), MakeShared<FRiderDeferredSourceCodeAccessor>(SlnName, FRiderSourceCodeAccessor::EProjectModel::Sln,
+		FRiderSourceCodeAccessor::EAccessType::Aggregate, [this]()
+		{
+			RequestSourceIndexes();
+			return WithRemoteFallback(GetInstallInfos());
+		}));
+#endif
+	ApplyAccessors(MoveTemp(Accessors));
+}
+
+TArray<FInstallInfo> FRiderSourceCodeAccessModule::GetKnownInstallInfos()
+{
+	{
+		FScopeLock Lock(&InstallInfosCriticalSection);
+		if (InstallInfosCache.IsSet()) return InstallInfosCache.GetValue();
+	}
+
+	// Only names accessors, a cache of any age will do for that
+	TArray<FInstallInfo> InstallInfos = FRiderInstallCache::Load(MAX_int32).Get({});
 	InstallInfos.Sort();
-	GenerateUprojectAccessors(InstallInfos);
-	GenerateSlnAccessors(InstallInfos);
+	return InstallInfos;
+}
+
+TArray<FInstallInfo> FRiderSourceCodeAccessModule::FilterUprojectInstalls(const TArray<FInstallInfo>& InstallInfos)
+{
+	return InstallInfos.FilterByPredicate([](const FInstallInfo& Item)
+	{
+		return Item.SupportUprojectState != FInstallInfo::ESupportUproject::None;
+	});
+}
+
+FName FRiderSourceCodeAccessModule::MakeAggregateName(const TArray<FInstallInfo>& InstallInfos, FRiderSourceCodeAccessor::EProjectModel Model)
+{
+	if (InstallInfos.Num() > 0)
+	{
+		return FRiderSourceCodeAccessor::MakeName(InstallInfos.Last(), Model, FRiderSourceCodeAccessor::EAccessType::Aggregate);
+	}
+
+	// Nothing known yet, current Rider versions support the .uproject model as a released feature
+	FInstallInfo ReleasedInstall(FString(), FInstallInfo::EInstallType::Installed);
+	ReleasedInstall.SupportUprojectState = FInstallInfo::ESupportUproject::Release;
+	return FRiderSourceCodeAccessor::MakeName(ReleasedInstall, Model, FRiderSourceCodeAccessor::EAccessType::Aggregate);
+}
+
+void FRiderSourceCodeAccessModule::AddInstallAccessor(const TArray<FInstallInfo>& InstallInfos, FRiderSourceCodeAccessor::EProjectModel Model, FRiderSourceCodeAccessor::EAccessType Type, FAccessorMap& OutAccessors)
+{
+	// Named up front after the newest install, the accessor is only initialized once the editor lists or selects it
+	const FName Name = Type == FRiderSourceCodeAccessor::EAccessType::Aggregate ? MakeAggregateName(InstallInfos, Model) : FRiderSourceCodeAccessor::MakeName(InstallInfos.Last(), Model, Type);
+	FString Key = Name.ToString();
+	for (const FInstallInfo& InstallInfo : InstallInfos)
+	{
+		Key += TEXT("|") + InstallInfo.GetPath();
+	}
+	OutAccessors.Add(Key, MakeShared<FRiderDeferredSourceCodeAccessor>(Name, Model, Type, [InstallInfos]() { return InstallInfos; }));
+}
+
+void FRiderSourceCodeAccessModule::ApplyAccessors(FAccessorMap&& Accessors)
+{
+	// Every registration change notifies the editor's listeners, so accessors that resolve to the same install stay registered
+	for (auto It = RiderSourceCodeAccessors.CreateIterator(); It; ++It)
+	{
+		if (!Accessors.Contains(It.Key()))
+		{
+			IModularFeatures::Get().UnregisterModularFeature(FRiderSourceCodeAccessor::FeatureType(), &It.Value().Get());
+			It.RemoveCurrent();
+		}
+	}
+	for (auto& Accessor : Accessors)
+	{
+		if (!RiderSourceCodeAccessors.Contains(Accessor.Key))
+		{
+			IModularFeatures::Get().RegisterModularFeature(FRiderSourceCodeAccessor::FeatureType(), &Accessor.Value.Get());
+			RiderSourceCodeAccessors.Add(Accessor.Key, Accessor.Value);
+		}
+	}
+}
+
+bool FRiderSourceCodeAccessModule::IsUprojectModelSelected() const
+{
+	const ISourceCodeAccessor& CurrentAccessor = FModuleManager::LoadModuleChecked<ISourceCodeAccessModule>(TEXT("SourceCodeAccess")).GetAccessor();
+	for (const auto& RiderSourceCodeAccessor : RiderSourceCodeAccessors)
+	{
+		if (&RiderSourceCodeAccessor.Value.Get() == &CurrentAccessor)
+		{
+			return RiderSourceCodeAccessor.Value->GetModel() == FRiderSourceCodeAccessor::EProjectModel::Uproject;
+		}
+	}
+	return false;
+}
+
+void FRiderSourceCodeAccessModule::PrelaunchIDE()
+{
+	// Only the accessor the user picked
+	ISourceCodeAccessor& CurrentAccessor = FModuleManager::LoadModuleChecked<ISourceCodeAccessModule>(TEXT("SourceCodeAccess")).GetAccessor();
+	for (const auto& RiderSourceCodeAccessor : RiderSourceCodeAccessors)
+	{
+		if (&RiderSourceCodeAccessor.Value.Get() == &CurrentAccessor)
+		{
+			RiderSourceCodeAccessor.Value->Prelaunch();
+			return;
+		}
+	}
+}
+
+void FRiderSourceCodeAccessModule::RunStartupBenchmark(int32 NumRuns)
+{
+	const FRiderSourceCodeAccessSettings ConfiguredSettings = FRiderSourceCodeAccessSettings::Get();
+	for (const bool bDefer : { false, true })
+	{
+		// Every run starts cold: no install cache, no handover from the previous run, no IDE launched and no UnrealBuildTool run
+		FRiderSourceCodeAccessSettings Settings = ConfiguredSettings;
+		Settings.bDeferDiscovery = bDefer;
+		Settings.InstallCacheLifetimeSeconds = 0;
+		Settings.bPrelaunchIDE = false;
+		Settings.bExportProjectModel = false;
+		FRiderSourceCodeAccessSettings::SetOverride(Settings);
+
+		double StartupSeconds = 0.0;
+		double FirstUseSeconds = 0.0;
+		double IndexSeconds = 0.0;
+		int32 NumIndexed = 0;
+		for (int32 Run = 0; Run < NumRuns; Run++)
+		{
+			ShutdownModule();
+			RiderReloadHandover::Take();
+
+			const double StartTime = FPlatformTime::Seconds();
+			StartupModule();
+			StartupSeconds += FPlatformTime::Seconds() - StartTime;
+
+			// What deferral moves from startup to the first accessor call
+			if (bDeferredDiscovery && RiderSourceCodeAccessors.Num() > 0)
+			{
+				const double FirstUseStartTime = FPlatformTime::Seconds();
+				RiderSourceCodeAccessors.CreateConstIterator().Value()->CanAccessSourceCode();
+				FirstUseSeconds += FPlatformTime::Seconds() - FirstUseStartTime;
+			}
+
+			const FRiderSourcePathIndex* SourcePathIndex = FRiderSourcePathIndex::Get();
+			while (SourcePathIndex != nullptr && !SourcePathIndex->IsReady() && FPlatformTime::Seconds() - StartTime < 600.0)
+			{
+				FPlatformProcess::Sleep(0.01f);
+			}
+			if (SourcePathIndex != nullptr && SourcePathIndex->IsReady())
+			{
+				IndexSeconds += FPlatformTime::Seconds() - StartTime;
+				NumIndexed++;
+			}
+		}
+
+		// Processes that can't render always defer, whatever the setting says
+		UE_LOG(LogRiderSourceCodeAccess, Display, TEXT("%s discovery, %d runs: startup %.2f ms, first accessor call %.2f ms, path index ready after %.2f ms in %d runs"),
+			bDeferredDiscovery ? TEXT("Deferred") : TEXT("Eager"), NumRuns, StartupSeconds * 1000.0 / NumRuns, FirstUseSeconds * 1000.0 / NumRuns,
+			NumIndexed > 0 ? IndexSeconds * 1000.0 / NumIndexed : 0.0, NumIndexed);
+	}
+
+	FRiderSourceCodeAccessSettings::SetOverride({});
+	ShutdownModule();
+	StartupModule();
 }
 
 bool FRiderSourceCodeAccessModule::SupportsDynamicReloading()
@@ -26,15 +400,105 @@ bool FRiderSourceCodeAccessModule::SupportsDynamicReloading()
 }
 
 void FRiderSourceCodeAccessModule::ShutdownModule()
+{
+	FRiderTicker::GetCoreTicker().RemoveTicker(PendingDiscoveryTickerHandle);
+	FCoreDelegates::OnFEngineLoopInitComplete.Remove(PrelaunchHandle);
+
+	// The discovery task runs code from this module, so it has to finish before the module is unloaded
+	if (PendingDiscovery.IsValid())
+	{
+		PendingDiscovery.Wait();
+	}
+	if (!IsEngineExitRequested())
+	{
+		StoreReloadHandover();
+	}
+	{
+		FScopeLock Lock(&InstallInfosCriticalSection);
+		InstallInfosCache.Reset();
+		PendingDiscovery.Reset();
+	}
+	HandedOverSourceFiles.Empty();
+	bSourceIndexesStarted = false;
+
+	FRiderProjectModelExporter::Shutdown();
+	FRiderSymbolIndex::Shutdown();
+	FRiderRemoteTransport::Shutdown();
+	FRiderPathCaseIndex::Shutdown();
+	FRiderSourcePathIndex::Shutdown();
+	FRiderSourceTreeWatcher::Shutdown();
+	UnregisterAccessors();
+	FRiderCallTrace::Shutdown();
+}
+
+void FRiderSourceCodeAccessModule::StoreReloadHandover()
+{
+	TArray<uint8> InstallsBlob;
+	{
+		FScopeLock Lock(&InstallInfosCriticalSection);
+		if (PendingDiscovery.IsValid())
+		{
+			TArray<FInstallInfo> InstallInfos = PendingDiscovery.Get().Array();
+			InstallInfos.Sort();
+			InstallsBlob = FRiderInstallCache::Serialize(InstallInfos);
+		}
+		else if (InstallInfosCache.IsSet())
+		{
+			InstallsBlob = FRiderInstallCache::Serialize(InstallInfosCache.GetValue());
+		}
+	}
+	// Files handed to this instance still go to the next one if nothing started the path index in between
+	TArray<FString> SourceFiles = HandedOverSourceFiles;
+	if (const FRiderSourcePathIndex* SourcePathIndex = FRiderSourcePathIndex::Get())
+	{
+		SourceFiles = SourcePathIndex->GetFiles();
+	}
+
+	TArray<uint8> Blob;
+	FMemoryWriter Writer(Blob);
+	int32 Version = ReloadHandoverVersion;
+	Writer << Version << InstallsBlob << SourceFiles;
+	RiderReloadHandover::Store(Blob);
+}
+
+TArray<FString> FRiderSourceCodeAccessModule::RestoreReloadHandover()
+{
+	const TArray<uint8> Blob = RiderReloadHandover::Take();
+	if (Blob.Num() == 0) return {};
+
+	FMemoryReader Reader(Blob);
+	int32 Version = 0;
+	Reader << Version;
+	if (Version != ReloadHandoverVersion) return {};
+
+	TArray<uint8> InstallsBlob;
+	TArray<FString> SourceFiles;
+	Reader << InstallsBlob << SourceFiles;
+	if (Reader.IsError()) return {};
+
+	// Launchers are checked again, a Rider uninstalled during the reload still means rediscovery
+	TOptional<TArray<FInstallInfo>> InstallInfos = FRiderInstallCache::Deserialize(InstallsBlob, MAX_int32);
+	if (InstallInfos.IsSet())
+	{
+		FScopeLock Lock(&InstallInfosCriticalSection);
+		InstallInfosCache = MoveTemp(InstallInfos.GetValue());
+	}
+	UE_LOG(LogRiderSourceCodeAccess, Log, TEXT("Reloaded with %d installs and %d indexed source files from the previous module instance"),
+		InstallInfosCache.IsSet() ? InstallInfosCache->Num() : 0, SourceFiles.Num());
+	return SourceFiles;
+}
+
+void FRiderSourceCodeAccessModule::UnregisterAccessors()
 {
 	for (auto& RiderSourceCodeAccessor : RiderSourceCodeAccessors)
 	{
 		// Unbind provider from editor
 		IModularFeatures::Get().UnregisterModularFeature(FRiderSourceCodeAccessor::FeatureType(), &(RiderSourceCodeAccessor.Value.Get()));
 	}
+	RiderSourceCodeAccessors.Empty();
 }
 
-void FRiderSourceCodeAccessModule::GenerateSlnAccessors(const TArray<FInstallInfo>& InstallInfos)
+void FRiderSourceCodeAccessModule::GenerateSlnAccessors(const TArray<FInstallInfo>& InstallInfos, FAccessorMap& OutAccessors)
 {
 #if PLATFORM_WINDOWS
 	if(InstallInfos.Num() == 0) return;
@@ -43,28 +507,17 @@ void FRiderSourceCodeAccessModule::GenerateSlnAccessors(const TArray<FInstallInf
 	{
 		for (const FInstallInfo& InstallInfo : InstallInfos)
 		{
-			TSharedRef<FRiderSourceCodeAccessor> RiderSourceCodeAccessor = MakeShareable(new FRiderSourceCodeAccessor());
-			RiderSourceCodeAccessor->Init(InstallInfo, FRiderSourceCodeAccessor::EProjectModel::Sln);
-			IModularFeatures::Get().RegisterModularFeature(FRiderSourceCodeAccessor::FeatureType(), &RiderSourceCodeAccessor.Get());
-			RiderSourceCodeAccessors.Add(RiderSourceCodeAccessor->GetFName(), RiderSourceCodeAccessor);
+			AddInstallAccessor({ InstallInfo }, FRiderSourceCodeAccessor::EProjectModel::Sln, FRiderSourceCodeAccessor::EAccessType::Direct, OutAccessors);
 		}
-
 	}
 
-	const TSharedRef<FRiderSourceCodeAccessor> RiderSourceCodeAccessor = MakeShareable(new FRiderSourceCodeAccessor());
-	RiderSourceCodeAccessor->Init(InstallInfos.Last(), FRiderSourceCodeAccessor::EProjectModel::Sln,
-	                              FRiderSourceCodeAccessor::EAccessType::Aggregate);
-	IModularFeatures::Get().RegisterModularFeature(FRiderSourceCodeAccessor::FeatureType(), &RiderSourceCodeAccessor.Get());
-	RiderSourceCodeAccessors.Add(TEXT("Rider"), RiderSourceCodeAccessor);
+	AddInstallAccessor(InstallInfos, FRiderSourceCodeAccessor::EProjectModel::Sln, FRiderSourceCodeAccessor::EAccessType::Aggregate, OutAccessors);
 #endif
 }
 
-void FRiderSourceCodeAccessModule::GenerateUprojectAccessors(const TArray<FInstallInfo>& InstallInfos)
+void FRiderSourceCodeAccessModule::GenerateUprojectAccessors(const TArray<FInstallInfo>& InstallInfos, FAccessorMap& OutAccessors)
 {
-	TArray<TArray<FInstallInfo>::ElementType> UprojectInfos = InstallInfos.FilterByPredicate([](const FInstallInfo& Item) -> bool
-	{
-		return Item.SupportUprojectState != FInstallInfo::ESupportUproject::None;
-	});
+	const TArray<FInstallInfo> UprojectInfos = FilterUprojectInstalls(InstallInfos);
 
 	if(UprojectInfos.Num() == 0) return;
 
@@ -72,22 +525,28 @@ void FRiderSourceCodeAccessModule::GenerateUprojectAccessors(const TArray<FInsta
 	{
 		for (const FInstallInfo& UprojectInfo : UprojectInfos)
 		{
-			TSharedRef<FRiderSourceCodeAccessor> RiderSourceCodeAccessor = MakeShareable(new FRiderSourceCodeAccessor());
-			RiderSourceCodeAccessor->Init(UprojectInfo, FRiderSourceCodeAccessor::EProjectModel::Uproject);
-			IModularFeatures::Get().RegisterModularFeature(FRiderSourceCodeAccessor::FeatureType(), &RiderSourceCodeAccessor.Get());
-			RiderSourceCodeAccessors.Add(RiderSourceCodeAccessor->GetFName(), RiderSourceCodeAccessor);
+			AddInstallAccessor({ UprojectInfo }, FRiderSourceCodeAccessor::EProjectModel::Uproject, FRiderSourceCodeAccessor::EAccessType::Direct, OutAccessors);
 		}
 	}
 
-	const TSharedRef<FRiderSourceCodeAccessor> RiderSourceCodeAccessor = MakeShareable(new FRiderSourceCodeAccessor());
-	RiderSourceCodeAccessor->Init(InstallInfos.Last(), FRiderSourceCodeAccessor::EProjectModel::Uproject,
-                                  FRiderSourceCodeAccessor::EAccessType::Aggregate);
-	IModularFeatures::Get().RegisterModularFeature(FRiderSourceCodeAccessor::FeatureType(), &RiderSourceCodeAccessor.Get());
-	FString AccessorName = TEXT("Rider uproject");
-	if(InstallInfos.Last().SupportUprojectState == FInstallInfo::ESupportUproject::Beta)
-		AccessorName += TEXT(" (experimental)");
-	
-	RiderSourceCodeAccessors.Add(*AccessorName, RiderSourceCodeAccessor);
+	AddInstallAccessor(UprojectInfos, FRiderSourceCodeAccessor::EProjectModel::Uproject, FRiderSourceCodeAccessor::EAccessType::Aggregate, OutAccessors);
 }
 
+/**
+ * Usage: Rider.Benchmark.Startup [NumRuns=5]
+ * Restarts the module in place, first with eager and then with deferred discovery, and logs the startup time, the first
+ * accessor call and when the path index is ready. Run it in an editor that renders, unattended processes always defer.
+ */
+static FAutoConsoleCommand RiderStartupBenchmarkCommand(
+	TEXT("Rider.Benchmark.Startup"),
+	TEXT("Restarts the module with eager and with deferred discovery and logs what each costs. Args: [NumRuns=5]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumRuns = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 5;
+		if (FRiderSourceCodeAccessModule* Module = FModuleManager::GetModulePtr<FRiderSourceCodeAccessModule>(TEXT("RiderSourceCodeAccess")))
+		{
+			Module->RunStartupBenchmark(NumRuns);
+		}
+	}));
+
 #undef LOCTEXT_NAMESPACE
@@ -3,6 +3,9 @@
 #pragma once
 
 #include "ISourceCodeAccessModule.h"
+#include "RiderDeferredSourceCodeAccessor.h"
+#include "RiderPathLocator/RiderPathLocator.h"
+#include "RiderTicker.h"
 
 class FRiderSourceCodeAccessModule : public IModuleInterface
 {
@@ -11,8 +14,65 @@ public:
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
 	virtual bool SupportsDynamicReloading() override;
+
+	/** Restarts the module in place with eager and with deferred discovery and logs what each costs, see Rider.Benchmark.Startup */
+	void RunStartupBenchmark(int32 NumRuns);
 private:
-	void GenerateSlnAccessors(const TArray<struct FInstallInfo>& InstallInfos);
-	void GenerateUprojectAccessors(const TArray<struct FInstallInfo>& InstallInfos);
-	TMultiMap<FName, TSharedRef<ISourceCodeAccessor>> RiderSourceCodeAccessors;
+	static bool ShouldDeferDiscovery();
+	TArray<FInstallInfo> GetInstallInfos();
+	TArray<FInstallInfo> CollectInstallInfos(bool& bOutComplete);
+	bool TickPendingDiscovery(float DeltaTime);
+	void PrelaunchIDE();
+
+	/** Whether the editor's current accessor is one of ours loading the .uproject, the only model the exported project model is for */
+	bool IsUprojectModelSelected() const;
+
+	/** Starts the path indexes, at startup or, with deferred discovery, once the first accessor resolves its installs. Game thread only */
+	void StartSourceIndexes();
+
+	/** StartSourceIndexes from any thread */
+	void RequestSourceIndexes();
+
+	/** Hands discovered installs and the source path index to the instance loaded next, and takes them back from it */
+	void StoreReloadHandover();
+	TArray<FString> RestoreReloadHandover();
+
+	/** Accessors keyed by what they resolve to, so regenerating them only touches the ones that changed */
+	using FAccessorMap = TMap<FString, TSharedRef<FRiderDeferredSourceCodeAccessor>>;
+
+	/** The remote host's stand-in install when none was discovered and a remote host is configured */
+	static TArray<FInstallInfo> WithRemoteFallback(TArray<FInstallInfo>&& InstallInfos);
+
+	void GenerateAccessors(const TArray<FInstallInfo>& InstallInfos);
+	/** Registers the aggregates without running discovery, again after discovery to rename them if their newest install changed */
+	void GenerateDeferredAccessors();
+
+	/** Installs known without running discovery: those of a reloaded module instance or of the install cache, at any age */
+	TArray<FInstallInfo> GetKnownInstallInfos();
+	static TArray<FInstallInfo> FilterUprojectInstalls(const TArray<FInstallInfo>& InstallInfos);
+
+	/** Aggregate accessor names in both modes, after the newest of InstallInfos (sorted oldest first) or a released install if empty */
+	static FName MakeAggregateName(const TArray<FInstallInfo>& InstallInfos, FRiderSourceCodeAccessor::EProjectModel Model);
+
+	static void GenerateSlnAccessors(const TArray<FInstallInfo>& InstallInfos, FAccessorMap& OutAccessors);
+	static void GenerateUprojectAccessors(const TArray<FInstallInfo>& InstallInfos, FAccessorMap& OutAccessors);
+	/** InstallInfos sorted oldest first, the accessor is named after the newest */
+	static void AddInstallAccessor(const TArray<FInstallInfo>& InstallInfos, FRiderSourceCodeAccessor::EProjectModel Model, FRiderSourceCodeAccessor::EAccessType Type, FAccessorMap& OutAccessors);
+	void ApplyAccessors(FAccessorMap&& Accessors);
+	void UnregisterAccessors();
+
+	/** Sorted by version, filled by the first GetInstallInfos call */
+	TOptional<TArray<FInstallInfo>> InstallInfosCache;
+	FCriticalSection InstallInfosCriticalSection;
+
+	/** Discovery still running after the time budget expired, replaces InstallInfosCache once done */
+	TFuture<TSet<FInstallInfo>> PendingDiscovery;
+	FRiderTickerHandle PendingDiscoveryTickerHandle;
+	bool bDeferredDiscovery = false;
+
+	/** Source files from the previous module instance, kept until the path index starts */
+	TArray<FString> HandedOverSourceFiles;
+	bool bSourceIndexesStarted = false;
+	FDelegateHandle PrelaunchHandle;
+	FAccessorMap RiderSourceCodeAccessors;
 };
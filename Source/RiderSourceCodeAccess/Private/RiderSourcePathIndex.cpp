@@ -0,0 +1,379 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderSourcePathIndex.h"
+
+#include "RiderSourceTree.h"
+
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeRWLock.h"
+
+static TUniquePtr<FRiderSourcePathIndex> SourcePathIndex;
+
+void FRiderSourcePathIndex::Initialize(TArray<FString>&& HandedOverFiles)
+{
+	if (SourcePathIndex.IsValid()) return;
+
+	FRiderSourceTreeWatcher::Initialize();
+	SourcePathIndex = MakeUnique<FRiderSourcePathIndex>();
+	SourcePathIndex->StartBuild(MoveTemp(HandedOverFiles));
+}
+
+void FRiderSourcePathIndex::Shutdown()
+{
+	SourcePathIndex.Reset();
+}
+
+FRiderSourcePathIndex* FRiderSourcePathIndex::Get()
+{
+	return SourcePathIndex.Get();
+}
+
+FRiderSourcePathIndex::~FRiderSourcePathIndex()
+{
+	if (FRiderSourceTreeWatcher* Watcher = FRiderSourceTreeWatcher::Get())
+	{
+		Watcher->OnFilesChanged().Remove(FilesChangedHandle);
+	}
+	{
+		// Under the lock so a lookup can't start another walk after this one was cancelled
+		FRWScopeLock WriteLock(Lock, SLT_Write);
+		bCancelBuild = true;
+	}
+	if (BuildTask.IsValid())
+	{
+		BuildTask.Wait();
+	}
+	if (RescanTask.IsValid())
+	{
+		RescanTask.Wait();
+	}
+}
+
+void FRiderSourcePathIndex::StartBuild(TArray<FString>&& HandedOverFiles)
+{
+	ProjectDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
+	FPaths::NormalizeDirectoryName(ProjectDir);
+	ProjectDir += TEXT("/");
+	if (FRiderSourceTreeWatcher* Watcher = FRiderSourceTreeWatcher::Get())
+	{
+		FilesChangedHandle = Watcher->OnFilesChanged().AddRaw(this, &FRiderSourcePathIndex::HandleFilesChanged);
+	}
+	const TArray<FString> WatchedRoots = RiderSourceTree::GetWatchedRoots();
+	EngineRoots = RiderSourceTree::GetSourceRoots().FilterByPredicate([&WatchedRoots](const FString& Root)
+	{
+		return !WatchedRoots.Contains(Root);
+	});
+	StartWalk(MoveTemp(HandedOverFiles));
+}
+
+void FRiderSourcePathIndex::StartWalk(TArray<FString>&& HandedOverFiles)
+{
+	// The walk takes minutes on a cold engine tree, so it gets a thread of its own instead of blocking a pool worker
+	const TArray<FString> Roots = RiderSourceTree::GetSourceRoots();
+	BuildTask = Async(EAsyncExecution::Thread, [this, Roots, HandedOverFiles = MoveTemp(HandedOverFiles)]()
+	{
+		// Files can change while the module is reloaded and nothing watches them, so the walk still runs afterwards
+		if (HandedOverFiles.Num() > 0)
+		{
+			FIndexData HandedOverData;
+			for (const FString& File : HandedOverFiles)
+			{
+				HandedOverData.AddFile(File);
+			}
+
+			FRWScopeLock WriteLock(Lock, SLT_Write);
+			Data = MoveTemp(HandedOverData);
+			bReady = true;
+			ApplyChanges(PendingChanges);
+		}
+
+		FIndexData NewData;
+		for (const FString& Root : Roots)
+		{
+			IFileManager::Get().IterateDirectoryRecursively(*Root, [this, &NewData](const TCHAR* Path, bool bIsDirectory)
+			{
+				if (bCancelBuild) return false;
+				if (!bIsDirectory && RiderSourceTree::IsSourceFile(Path))
+				{
+					NewData.AddFile(Path);
+				}
+				return true;
+			});
+		}
+		if (bCancelBuild) return;
+
+		FRWScopeLock WriteLock(Lock, SLT_Write);
+		Data = MoveTemp(NewData);
+		bReady = true;
+		bWalked = true;
+		ApplyChanges(PendingChanges);
+		PendingChanges.Empty();
+	});
+}
+
+FString FRiderSourcePathIndex::FindRescanDirectory(const FString& Path) const
+{
+	FString NormalizedPath = TEXT("/") + Path;
+	FPaths::NormalizeFilename(NormalizedPath);
+	for (const FString& Root : EngineRoots)
+	{
+		// Foreign paths are re-rooted at the last "Engine/Source/" or "Engine/Plugins/" they contain
+		const FString RootTail = FString::Printf(TEXT("/%s/%s/"), *FPaths::GetCleanFilename(FPaths::GetPath(Root)), *FPaths::GetCleanFilename(Root));
+		const int32 TailIndex = NormalizedPath.Find(RootTail, ESearchCase::IgnoreCase, ESearchDir::FromEnd);
+		if (TailIndex == INDEX_NONE) continue;
+
+		// A directory that doesn't exist locally is looked for in its closest existing parent, never in the whole root
+		FString Directory = FPaths::GetPath(Root / NormalizedPath.Mid(TailIndex + RootTail.Len()));
+		while (Directory.Len() > Root.Len() && !FPaths::DirectoryExists(Directory))
+		{
+			Directory = FPaths::GetPath(Directory);
+		}
+		return Directory.Len() > Root.Len() ? Directory : FString();
+	}
+	return FString();
+}
+
+void FRiderSourcePathIndex::RequestRescan(const FString& Directory) const
+{
+	if (Directory.IsEmpty()) return;
+
+	FRWScopeLock WriteLock(Lock, SLT_Write);
+	if (!bWalked || bCancelBuild) return;
+
+	const double Now = FPlatformTime::Seconds();
+	const double* RescanTime = RescanTimes.Find(Directory);
+	if (RescanTime != nullptr && Now - *RescanTime < MinRescanIntervalSeconds) return;
+
+	RescanTimes.Add(Directory, Now);
+	PendingRescans.AddUnique(Directory);
+	if (bRescanning) return;
+
+	bRescanning = true;
+	RescanTask = Async(EAsyncExecution::Thread, [this]()
+	{
+		RescanPending();
+	});
+}
+
+void FRiderSourcePathIndex::RescanPending() const
+{
+	for (;;)
+	{
+		FString Directory;
+		{
+			FRWScopeLock WriteLock(Lock, SLT_Write);
+			if (PendingRescans.Num() == 0 || bCancelBuild)
+			{
+				bRescanning = false;
+				return;
+			}
+			Directory = PendingRescans.Pop();
+		}
+
+		TSet<FString> Found;
+		IFileManager::Get().IterateDirectoryRecursively(*Directory, [this, &Found](const TCHAR* Path, bool bIsDirectory)
+		{
+			if (bCancelBuild) return false;
+			if (!bIsDirectory && RiderSourceTree::IsSourceFile(Path))
+			{
+				Found.Add(Path);
+			}
+			return true;
+		});
+		if (bCancelBuild) continue;
+
+		// Only the rescanned directory is replaced, the rest of the index stays as it is
+		FRWScopeLock WriteLock(Lock, SLT_Write);
+		const FString Prefix = Directory + TEXT("/");
+		TArray<FString> Removed;
+		for (const FString& File : Data.Files)
+		{
+			if (!File.IsEmpty() && File.StartsWith(Prefix) && !Found.Contains(File))
+			{
+				Removed.Add(File);
+			}
+		}
+		for (const FString& File : Removed)
+		{
+			Data.RemoveFile(File);
+		}
+		for (const FString& File : Found)
+		{
+			Data.AddFile(File);
+		}
+	}
+}
+
+bool FRiderSourcePathIndex::IsReady() const
+{
+	FRWScopeLock ReadLock(Lock, SLT_ReadOnly);
+	return bReady;
+}
+
+bool FRiderSourcePathIndex::IsWalked() const
+{
+	FRWScopeLock ReadLock(Lock, SLT_ReadOnly);
+	return bWalked;
+}
+
+TArray<FString> FRiderSourcePathIndex::GetFiles() const
+{
+	FRWScopeLock ReadLock(Lock, SLT_ReadOnly);
+	TArray<FString> Result;
+	Result.Reserve(Data.NumFiles);
+	for (const FString& File : Data.Files)
+	{
+		if (!File.IsEmpty())
+		{
+			Result.Add(File);
+		}
+	}
+	return Result;
+}
+
+void FRiderSourcePathIndex::HandleFilesChanged(const TArray<FFileChangeData>& Changes)
+{
+	FRWScopeLock WriteLock(Lock, SLT_Write);
+	if (bReady)
+	{
+		ApplyChanges(Changes);
+	}
+	if (!bWalked)
+	{
+		PendingChanges.Append(Changes);
+	}
+}
+
+void FRiderSourcePathIndex::ApplyChanges(const TArray<FFileChangeData>& Changes) const
+{
+	for (const FFileChangeData& Change : Changes)
+	{
+		if (!RiderSourceTree::IsSourceFile(Change.Filename)) continue;
+
+		FString Path = Change.Filename;
+		FPaths::NormalizeFilename(Path);
+		if (Change.Action == FFileChangeData::FCA_Added)
+		{
+			Data.AddFile(Path);
+		}
+		else if (Change.Action == FFileChangeData::FCA_Removed)
+		{
+			Data.RemoveFile(Path);
+		}
+	}
+}
+
+void FRiderSourcePathIndex::SplitComponents(const FString& Path, TArray<FString>& OutComponents)
+{
+	FString NormalizedPath = Path;
+	FPaths::NormalizeFilename(NormalizedPath);
+	NormalizedPath.ParseIntoArray(OutComponents, TEXT("/"));
+}
+
+int32 FRiderSourcePathIndex::CountMatchingSuffix(const FString& Path, const TArray<FString>& Components)
+{
+	int32 Count = 0;
+	int32 End = Path.Len();
+	for (int32 Index = Components.Num() - 1; Index >= 0; Index--)
+	{
+		const FString& Component = Components[Index];
+		const int32 Start = End - Component.Len();
+		if (Start < 0 || FCString::Strnicmp(*Path + Start, *Component, Component.Len()) != 0) break;
+		if (Start > 0 && Path[Start - 1] != TEXT('/')) break;
+		Count++;
+		End = Start - 1;
+	}
+	return Count;
+}
+
+void FRiderSourcePathIndex::FIndexData::AddFile(const FString& Path)
+{
+	if (FindFile(Path) != INDEX_NONE) return;
+
+	// FString hashing ignores case, so paths from case-insensitive file systems still hit
+	const int32 FileIndex = Files.Add(Path);
+	PathToFiles.Add(GetTypeHash(Path), FileIndex);
+	NameToFiles.Add(GetTypeHash(FPaths::GetCleanFilename(Path)), FileIndex);
+	NumFiles++;
+}
+
+int32 FRiderSourcePathIndex::FIndexData::FindFile(const FString& Path) const
+{
+	TArray<int32, TInlineAllocator<4>> Candidates;
+	PathToFiles.MultiFind(GetTypeHash(Path), Candidates);
+	for (const int32 FileIndex : Candidates)
+	{
+		if (Files[FileIndex].Equals(Path, ESearchCase::CaseSensitive)) return FileIndex;
+	}
+	return INDEX_NONE;
+}
+
+void FRiderSourcePathIndex::FIndexData::RemoveFile(const FString& Path)
+{
+	const int32 FileIndex = FindFile(Path);
+	if (FileIndex == INDEX_NONE) return;
+
+	// The name entry is left in place and skipped on lookup, re-adding the file takes a new slot
+	PathToFiles.RemoveSingle(GetTypeHash(Path), FileIndex);
+	Files[FileIndex].Empty();
+	NumFiles--;
+}
+
+TOptional<FString> FRiderSourcePathIndex::Resolve(const FString& ForeignPath) const
+{
+	TArray<FString> Components;
+	SplitComponents(ForeignPath, Components);
+	if (Components.Num() == 0) return {};
+
+	TOptional<FString> Result;
+	{
+		FRWScopeLock ReadLock(Lock, SLT_ReadOnly);
+		if (!bReady) return {};
+
+		TArray<int32, TInlineAllocator<8>> Candidates;
+		Data.NameToFiles.MultiFind(GetTypeHash(Components.Last()), Candidates);
+
+		const FString* Match = nullptr;
+		int32 MatchCount = 0;
+		int32 NumMatches = 0;
+		for (const int32 FileIndex : Candidates)
+		{
+			const FString& File = Data.Files[FileIndex];
+			const int32 Count = File.IsEmpty() ? 0 : CountMatchingSuffix(File, Components);
+			if (Count == 0 || Count < MatchCount) continue;
+			if (Count > MatchCount)
+			{
+				Match = &File;
+				MatchCount = Count;
+				NumMatches = 1;
+				continue;
+			}
+
+			// Equally long matches: the project's copy, then the shortest path, then the first in order
+			NumMatches++;
+			const bool bIsProject = File.StartsWith(ProjectDir);
+			const bool bMatchIsProject = Match->StartsWith(ProjectDir);
+			if (bIsProject != bMatchIsProject ? bIsProject : (File.Len() != Match->Len() ? File.Len() < Match->Len() : File < *Match))
+			{
+				Match = &File;
+			}
+		}
+
+		// A bare file name is only trusted when it is unique
+		if (Match != nullptr && (MatchCount > 1 || NumMatches == 1))
+		{
+			Result = *Match;
+		}
+	}
+
+	// The engine trees aren't watched, a miss or a file that went away means the directory may have changed since it was read
+	if (!Result.IsSet() || !FPaths::FileExists(Result.GetValue()))
+	{
+		RequestRescan(FindRescanDirectory(Result.IsSet() ? Result.GetValue() : ForeignPath));
+		return {};
+	}
+	return Result;
+}
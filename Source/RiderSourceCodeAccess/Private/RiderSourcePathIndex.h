@@ -0,0 +1,114 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Templates/Atomic.h"
+#include "IDirectoryWatcher.h"
+
+/**
+ * Resolves paths from other machines (crash reports, profiler captures) to local source files by their longest
+ * matching suffix. Built in the background over the engine and project source trees. The project's trees are kept up
+ * to date from directory watcher events. The engine's aren't watched, a lookup that finds nothing or a stale file
+ * rescans just the engine directory the path points at.
+ */
+class FRiderSourcePathIndex
+{
+public:
+	/**
+	 * Must be called on the game thread, starts the background build.
+	 * HandedOverFiles from a previous module instance serve lookups until the directory walk has caught up.
+	 */
+	static void Initialize(TArray<FString>&& HandedOverFiles = {});
+	static void Shutdown();
+
+	/** Null until Initialize has been called */
+	static FRiderSourcePathIndex* Get();
+
+	~FRiderSourcePathIndex();
+
+	/**
+	 * Local file whose path shares the longest suffix with ForeignPath, unset if the index isn't built yet or nothing matches.
+	 * Among equally long matches project files win, then the shortest path.
+	 */
+	TOptional<FString> Resolve(const FString& ForeignPath) const;
+
+	bool IsReady() const;
+
+	/** Whether the directory walk finished, until then lookups and GetFiles may be served from handed over files */
+	bool IsWalked() const;
+
+	/** Every indexed file, empty if the index isn't built yet */
+	TArray<FString> GetFiles() const;
+
+private:
+	struct FIndexData
+	{
+		/** Normalized absolute paths, removed files leave an empty slot */
+		TArray<FString> Files;
+
+		/** Hash of the full path -> file, the path itself is only stored in Files */
+		TMultiMap<uint32, int32> PathToFiles;
+
+		/** Hash of the file name -> files, longer suffixes are compared on lookup */
+		TMultiMap<uint32, int32> NameToFiles;
+
+		int32 NumFiles = 0;
+
+		void AddFile(const FString& Path);
+		void RemoveFile(const FString& Path);
+		int32 FindFile(const FString& Path) const;
+	};
+
+	/** A directory is rescanned at most this often */
+	static constexpr double MinRescanIntervalSeconds = 60.0;
+
+	static void SplitComponents(const FString& Path, TArray<FString>& OutComponents);
+	static int32 CountMatchingSuffix(const FString& Path, const TArray<FString>& Components);
+
+	void StartBuild(TArray<FString>&& HandedOverFiles);
+
+	/** Walks every root in the background, lookups keep using the handed over data until it's done */
+	void StartWalk(TArray<FString>&& HandedOverFiles);
+
+	/**
+	 * The deepest existing local directory below an engine root that Path, local or foreign, points into.
+	 * Empty for paths outside the engine roots, which are watched or not indexed at all.
+	 */
+	FString FindRescanDirectory(const FString& Path) const;
+	void RequestRescan(const FString& Directory) const;
+
+	/** Rescans queued directories one after the other, on the rescan thread */
+	void RescanPending() const;
+	void HandleFilesChanged(const TArray<FFileChangeData>& Changes);
+	void ApplyChanges(const TArray<FFileChangeData>& Changes) const;
+
+	/** Normalized, with a trailing slash */
+	FString ProjectDir;
+
+	/** Normalized roots that aren't watched for changes */
+	TArray<FString> EngineRoots;
+
+	mutable FRWLock Lock;
+	mutable FIndexData Data;
+	mutable bool bReady = false;
+
+	/** Set once the directory walk finished, lookups can be served from handed over files before that */
+	mutable bool bWalked = false;
+
+	/** Changes reported while the directory walk was still running */
+	mutable TArray<FFileChangeData> PendingChanges;
+
+	/** Directories waiting for a rescan, and when each was last queued */
+	mutable TArray<FString> PendingRescans;
+	mutable TMap<FString, double> RescanTimes;
+	mutable bool bRescanning = false;
+
+	TFuture<void> BuildTask;
+
+	/** Replaced only under the write lock once the previous rescan finished */
+	mutable TFuture<void> RescanTask;
+	mutable TAtomic<bool> bCancelBuild { false };
+	FDelegateHandle FilesChangedHandle;
+};
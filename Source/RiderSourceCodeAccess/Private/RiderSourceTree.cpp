@@ -0,0 +1,125 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderSourceTree.h"
+
+#include "DirectoryWatcherModule.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+
+static TUniquePtr<FRiderSourceTreeWatcher> SourceTreeWatcher;
+
+static TArray<FString> GetExistingRoots(const TArray<FString>& Roots)
+{
+	TArray<FString> Result;
+	for (const FString& Root : Roots)
+	{
+		FString FullRoot = FPaths::ConvertRelativePathToFull(Root);
+		FPaths::NormalizeDirectoryName(FullRoot);
+		if (FPaths::DirectoryExists(FullRoot))
+		{
+			Result.AddUnique(FullRoot);
+		}
+	}
+	return Result;
+}
+
+TArray<FString> RiderSourceTree::GetSourceRoots()
+{
+	TArray<FString> Roots = {
+		FPaths::EngineSourceDir(),
+		FPaths::EnginePluginsDir()
+	};
+	Roots.Append(GetWatchedRoots());
+	return GetExistingRoots(Roots);
+}
+
+TArray<FString> RiderSourceTree::GetWatchedRoots()
+{
+	if (!FPaths::IsProjectFilePathSet()) return {};
+
+	return GetExistingRoots({ FPaths::GameSourceDir(), FPaths::ProjectPluginsDir() });
+}
+
+bool RiderSourceTree::IsSourceFile(const FString& Path)
+{
+	static const TSet<FString> SourceExtensions = {
+		TEXT("h"), TEXT("hh"), TEXT("hpp"), TEXT("hxx"), TEXT("inl"),
+		TEXT("c"), TEXT("cc"), TEXT("cpp"), TEXT("cxx"),
+		TEXT("ispc"), TEXT("usf"), TEXT("ush"), TEXT("cs")
+	};
+	return SourceExtensions.Contains(FPaths::GetExtension(Path));
+}
+
+TOptional<FString> RiderSourceTree::FindModuleBuildFile(const FString& SourcePath, const TArray<FString>& AvailableModules)
+{
+	TOptional<FString> Result;
+	int32 ResultDirLen = 0;
+	for (const FString& Module : AvailableModules)
+	{
+		if (!Module.EndsWith(TEXT(".Build.cs"))) continue;
+
+		FString ModuleDir = FPaths::ConvertRelativePathToFull(FPaths::GetPath(Module));
+		FPaths::NormalizeDirectoryName(ModuleDir);
+		if (!SourcePath.StartsWith(ModuleDir + TEXT("/")) || ModuleDir.Len() <= ResultDirLen) continue;
+
+		Result = Module;
+		ResultDirLen = ModuleDir.Len();
+	}
+	return Result;
+}
+
+void FRiderSourceTreeWatcher::Initialize()
+{
+	if (SourceTreeWatcher.IsValid()) return;
+
+	SourceTreeWatcher = MakeUnique<FRiderSourceTreeWatcher>();
+	SourceTreeWatcher->RegisterWatches();
+}
+
+void FRiderSourceTreeWatcher::Shutdown()
+{
+	if (!SourceTreeWatcher.IsValid()) return;
+
+	SourceTreeWatcher->UnregisterWatches();
+	SourceTreeWatcher.Reset();
+}
+
+FRiderSourceTreeWatcher* FRiderSourceTreeWatcher::Get()
+{
+	return SourceTreeWatcher.Get();
+}
+
+void FRiderSourceTreeWatcher::RegisterWatches()
+{
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get();
+	if (DirectoryWatcher == nullptr) return;
+
+	for (const FString& Root : RiderSourceTree::GetWatchedRoots())
+	{
+		FDelegateHandle Handle;
+		if (DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(Root, IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FRiderSourceTreeWatcher::HandleDirectoryChanged), Handle))
+		{
+			WatchHandles.Emplace(Root, Handle);
+		}
+	}
+}
+
+void FRiderSourceTreeWatcher::UnregisterWatches()
+{
+	FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule != nullptr ? DirectoryWatcherModule->Get() : nullptr;
+	if (DirectoryWatcher != nullptr)
+	{
+		for (const TPair<FString, FDelegateHandle>& WatchHandle : WatchHandles)
+		{
+			DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(WatchHandle.Key, WatchHandle.Value);
+		}
+	}
+	WatchHandles.Empty();
+}
+
+void FRiderSourceTreeWatcher::HandleDirectoryChanged(const TArray<FFileChangeData>& Changes)
+{
+	FilesChanged.Broadcast(Changes);
+}
@@ -0,0 +1,46 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IDirectoryWatcher.h"
+
+namespace RiderSourceTree
+{
+	/** Absolute, normalized roots of the engine and project source and plugin trees */
+	TArray<FString> GetSourceRoots();
+
+	/**
+	 * The project's source and plugin roots, the only ones watched for changes. Watching the engine trees takes one
+	 * inotify watch per directory on Linux and can exhaust max_user_watches, indexes rescan them on demand instead.
+	 */
+	TArray<FString> GetWatchedRoots();
+
+	/** Whether the file is something a stack trace or a declaration can point at */
+	bool IsSourceFile(const FString& Path);
+
+	/** The .Build.cs among AvailableModules whose directory is the closest parent of SourcePath, the module an added file belongs to */
+	TOptional<FString> FindModuleBuildFile(const FString& SourcePath, const TArray<FString>& AvailableModules);
+}
+
+/** Watches the project's source roots once and fans the changes out to every index built over them */
+class FRiderSourceTreeWatcher
+{
+public:
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnFilesChanged, const TArray<FFileChangeData>&);
+
+	/** Must be called on the game thread */
+	static void Initialize();
+	static void Shutdown();
+	static FRiderSourceTreeWatcher* Get();
+
+	FOnFilesChanged& OnFilesChanged() { return FilesChanged; }
+
+private:
+	void RegisterWatches();
+	void UnregisterWatches();
+	void HandleDirectoryChanged(const TArray<FFileChangeData>& Changes);
+
+	TArray<TPair<FString, FDelegateHandle>> WatchHandles;
+	FOnFilesChanged FilesChanged;
+};
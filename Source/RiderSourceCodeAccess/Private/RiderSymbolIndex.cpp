@@ -0,0 +1,415 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RiderSymbolIndex.h"
+
+#include "RiderSourcePathIndex.h"
+#include "RiderSourceTree.h"
+
+#include "ISourceCodeAccessModule.h"
+
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeRWLock.h"
+#include "Modules/ModuleManager.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRiderSymbolIndex, Log, All);
+
+static TUniquePtr<FRiderSymbolIndex> SymbolIndex;
+
+namespace RiderSymbolIndex
+{
+	static const uint32 Magic = 0x52534958; // 'RSIX'
+
+	/** Identifiers, and the punctuation that ends a declaration's name, of one line */
+	static void Tokenize(const FString& Line, TArray<FString>& OutTokens)
+	{
+		const TCHAR* Cursor = *Line;
+		while (*Cursor != TEXT('\0'))
+		{
+			if (FChar::IsAlnum(*Cursor) || *Cursor == TEXT('_'))
+			{
+				const TCHAR* Start = Cursor;
+				while (FChar::IsAlnum(*Cursor) || *Cursor == TEXT('_')) Cursor++;
+				OutTokens.Emplace(static_cast<int32>(Cursor - Start), Start);
+				continue;
+			}
+			if (*Cursor == TEXT('/') && Cursor[1] == TEXT('/')) return;
+			if (*Cursor == TEXT(':') || *Cursor == TEXT('{') || *Cursor == TEXT('(') || *Cursor == TEXT(';') || *Cursor == TEXT('<'))
+			{
+				OutTokens.Emplace(1, Cursor);
+			}
+			Cursor++;
+		}
+	}
+
+	static bool IsPunctuation(const FString& Token)
+	{
+		return Token.Len() == 1 && !FChar::IsAlnum(Token[0]) && Token[0] != TEXT('_');
+	}
+
+	/** "class ENGINE_API AActor : public UObject" -> AActor, "enum class EFoo : uint8" -> EFoo */
+	static FString GetTypeName(const TArray<FString>& Tokens)
+	{
+		FString Name;
+		for (const FString& Token : Tokens)
+		{
+			if (IsPunctuation(Token)) break;
+			if (Token == TEXT("class") || Token == TEXT("struct") || Token == TEXT("enum") || Token == TEXT("namespace")
+				|| Token == TEXT("final") || Token.EndsWith(TEXT("_API"))) continue;
+			Name = Token;
+		}
+		return Name;
+	}
+
+	/** "virtual void BeginPlay() override" -> BeginPlay, empty while the parameter list hasn't started yet */
+	static FString GetFunctionName(const TArray<FString>& Tokens)
+	{
+		for (int32 Index = 1; Index < Tokens.Num(); Index++)
+		{
+			if (Tokens[Index] == TEXT("(") && !IsPunctuation(Tokens[Index - 1])) return Tokens[Index - 1];
+		}
+		return FString();
+	}
+}
+
+void FRiderSymbolIndex::Initialize()
+{
+	if (SymbolIndex.IsValid() || !FPaths::IsProjectFilePathSet()) return;
+
+	FRiderSourcePathIndex::Initialize();
+	SymbolIndex = MakeUnique<FRiderSymbolIndex>();
+	SymbolIndex->StartBuild();
+}
+
+void FRiderSymbolIndex::Shutdown()
+{
+	SymbolIndex.Reset();
+}
+
+FRiderSymbolIndex* FRiderSymbolIndex::Get()
+{
+	return SymbolIndex.Get();
+}
+
+FString FRiderSymbolIndex::GetIndexPath()
+{
+	return FPaths::Combine(FPaths::ConvertRelativePathToFull(FPaths::ProjectIntermediateDir()), TEXT("Rider"), TEXT("SymbolIndex.bin"));
+}
+
+FRiderSymbolIndex::~FRiderSymbolIndex()
+{
+	if (FRiderSourceTreeWatcher* Watcher = FRiderSourceTreeWatcher::Get())
+	{
+		Watcher->OnFilesChanged().Remove(FilesChangedHandle);
+	}
+	if (BuildTask.IsValid())
+	{
+		bCancelBuild = true;
+		BuildTask.Wait();
+	}
+	if (bReady && bDirty)
+	{
+		Save(Data.Files);
+	}
+}
+
+bool FRiderSymbolIndex::IsIndexedFile(const FString& Path)
+{
+	// UnrealHeaderTool only reads .h files, so nothing else can hold a reflected declaration
+	return FPaths::GetExtension(Path) == TEXT("h");
+}
+
+void FRiderSymbolIndex::StartBuild()
+{
+	if (FRiderSourceTreeWatcher* Watcher = FRiderSourceTreeWatcher::Get())
+	{
+		FilesChangedHandle = Watcher->OnFilesChanged().AddRaw(this, &FRiderSymbolIndex::HandleFilesChanged);
+	}
+
+	// Parsing a cold engine takes minutes, so the build gets a thread of its own instead of blocking a pool worker
+	const FRiderSourcePathIndex* SourcePathIndex = FRiderSourcePathIndex::Get();
+	BuildTask = Async(EAsyncExecution::Thread, [this, SourcePathIndex]()
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		TMap<FString, FFileEntry> StoredFiles;
+		Load(StoredFiles);
+
+		// The headers come from the path index's walk, the trees aren't listed a second time
+		while (SourcePathIndex != nullptr && !SourcePathIndex->IsWalked())
+		{
+			if (bCancelBuild) return;
+			FPlatformProcess::Sleep(0.1f);
+		}
+		const TArray<FString> Files = SourcePathIndex != nullptr ? SourcePathIndex->GetFiles() : TArray<FString>();
+
+		// Unchanged headers keep their stored symbols, only new and modified ones are parsed
+		FIndexData NewData;
+		int32 NumParsed = 0;
+		for (const FString& File : Files)
+		{
+			if (bCancelBuild) return;
+			if (!IsIndexedFile(File)) continue;
+
+			FString Path = File;
+			FPaths::NormalizeFilename(Path);
+			const FFileStatData StatData = IFileManager::Get().GetStatData(*Path);
+			if (!StatData.bIsValid) continue;
+
+			FFileEntry Entry;
+			if (!StoredFiles.RemoveAndCopyValue(Path, Entry) || Entry.ModificationTicks != StatData.ModificationTime.GetTicks() || Entry.Size != StatData.FileSize)
+			{
+				Entry.ModificationTicks = StatData.ModificationTime.GetTicks();
+				Entry.Size = StatData.FileSize;
+				Entry.Symbols = ParseFile(Path);
+				NumParsed++;
+			}
+			NewData.SetFile(Path, MoveTemp(Entry));
+		}
+
+		const bool bChanged = NumParsed > 0 || StoredFiles.Num() > 0;
+		if (bChanged && !Save(NewData.Files))
+		{
+			UE_LOG(LogRiderSymbolIndex, Verbose, TEXT("Couldn't write the symbol index to %s"), *GetIndexPath());
+		}
+		UE_LOG(LogRiderSymbolIndex, Log, TEXT("Symbol index over %d headers ready in %.2f s, %d parsed, %d removed"),
+			NewData.Files.Num(), FPlatformTime::Seconds() - StartTime, NumParsed, StoredFiles.Num());
+
+		FRWScopeLock WriteLock(Lock, SLT_Write);
+		Data = MoveTemp(NewData);
+		bReady = true;
+		ApplyChanges(PendingChanges);
+		PendingChanges.Empty();
+	});
+}
+
+bool FRiderSymbolIndex::IsReady() const
+{
+	FRWScopeLock ReadLock(Lock, SLT_ReadOnly);
+	return bReady;
+}
+
+TArray<FRiderSymbolIndex::FSymbolLocation> FRiderSymbolIndex::Find(const FString& Name) const
+{
+	TArray<FSymbolLocation> Result;
+	FRWScopeLock ReadLock(Lock, SLT_ReadOnly);
+	Data.Symbols.MultiFind(Name, Result, true);
+	return Result;
+}
+
+TOptional<FRiderSymbolIndex::FSymbolLocation> FRiderSymbolIndex::FindBest(const FString& Name) const
+{
+	const TArray<FSymbolLocation> Locations = Find(Name);
+	if (Locations.Num() == 0) return {};
+
+	// Names declared by both, e.g. a project type shadowing a plugin one, most likely mean the project's
+	const FString ProjectDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
+	const FSymbolLocation* ProjectLocation = Locations.FindByPredicate([&ProjectDir](const FSymbolLocation& Location)
+	{
+		return Location.File.StartsWith(ProjectDir);
+	});
+	return ProjectLocation != nullptr ? *ProjectLocation : Locations[0];
+}
+
+void FRiderSymbolIndex::HandleFilesChanged(const TArray<FFileChangeData>& Changes)
+{
+	FRWScopeLock WriteLock(Lock, SLT_Write);
+	if (!bReady)
+	{
+		PendingChanges.Append(Changes);
+		return;
+	}
+	ApplyChanges(Changes);
+}
+
+void FRiderSymbolIndex::ApplyChanges(const TArray<FFileChangeData>& Changes)
+{
+	for (const FFileChangeData& Change : Changes)
+	{
+		if (!IsIndexedFile(Change.Filename)) continue;
+
+		FString Path = Change.Filename;
+		FPaths::NormalizeFilename(Path);
+		const FFileStatData StatData = IFileManager::Get().GetStatData(*Path);
+		if (Change.Action == FFileChangeData::FCA_Removed || !StatData.bIsValid)
+		{
+			Data.RemoveFile(Path);
+		}
+		else
+		{
+			FFileEntry Entry;
+			Entry.ModificationTicks = StatData.ModificationTime.GetTicks();
+			Entry.Size = StatData.FileSize;
+			Entry.Symbols = ParseFile(Path);
+			Data.SetFile(Path, MoveTemp(Entry));
+		}
+		bDirty = true;
+	}
+}
+
+void FRiderSymbolIndex::FIndexData::SetFile(const FString& Path, FFileEntry&& Entry)
+{
+	RemoveFile(Path);
+	for (const FSymbol& Symbol : Entry.Symbols)
+	{
+		Symbols.Add(Symbol.Name, { Path, Symbol.Line, Symbol.Kind });
+
+		// Functions are stored qualified, "Class::Function", and are found by their plain name as well
+		int32 SeparatorIndex;
+		if (Symbol.Kind == ESymbolKind::Function && Symbol.Name.FindLastChar(TEXT(':'), SeparatorIndex))
+		{
+			Symbols.Add(Symbol.Name.Mid(SeparatorIndex + 1), { Path, Symbol.Line, Symbol.Kind });
+		}
+	}
+	Files.Add(Path, MoveTemp(Entry));
+}
+
+void FRiderSymbolIndex::FIndexData::RemoveFile(const FString& Path)
+{
+	FFileEntry Entry;
+	if (!Files.RemoveAndCopyValue(Path, Entry)) return;
+
+	for (const FSymbol& Symbol : Entry.Symbols)
+	{
+		Symbols.Remove(Symbol.Name, { Path, Symbol.Line, Symbol.Kind });
+		int32 SeparatorIndex;
+		if (Symbol.Kind == ESymbolKind::Function && Symbol.Name.FindLastChar(TEXT(':'), SeparatorIndex))
+		{
+			Symbols.Remove(Symbol.Name.Mid(SeparatorIndex + 1), { Path, Symbol.Line, Symbol.Kind });
+		}
+	}
+}
+
+TArray<FRiderSymbolIndex::FSymbol> FRiderSymbolIndex::ParseFile(const FString& Path)
+{
+	using namespace RiderSymbolIndex;
+
+	TArray<FSymbol> Symbols;
+	FString Text;
+	if (!FFileHelper::LoadFileToString(Text, *Path) || !Text.Contains(TEXT(".generated.h"))) return Symbols;
+
+	TArray<FString> Lines;
+	Text.ParseIntoArrayLines(Lines, false);
+
+	// Functions belong to the last reflected type declared above them, interface functions to its I-prefixed twin
+	FString OwnerName;
+	TArray<FString> Tokens;
+	for (int32 LineIndex = 0; LineIndex < Lines.Num(); LineIndex++)
+	{
+		const FString Line = Lines[LineIndex].TrimStart();
+		TOptional<ESymbolKind> Kind;
+		if (Line.StartsWith(TEXT("UCLASS("), ESearchCase::CaseSensitive)) Kind = ESymbolKind::Class;
+		else if (Line.StartsWith(TEXT("USTRUCT("), ESearchCase::CaseSensitive)) Kind = ESymbolKind::Struct;
+		else if (Line.StartsWith(TEXT("UINTERFACE("), ESearchCase::CaseSensitive)) Kind = ESymbolKind::Interface;
+		else if (Line.StartsWith(TEXT("UENUM("), ESearchCase::CaseSensitive)) Kind = ESymbolKind::Enum;
+		else if (Line.StartsWith(TEXT("UFUNCTION("), ESearchCase::CaseSensitive)) Kind = ESymbolKind::Function;
+		if (!Kind.IsSet()) continue;
+
+		// Macro arguments can span lines, the declaration starts after the closing parenthesis
+		int32 Depth = 0;
+		for (; LineIndex < Lines.Num(); LineIndex++)
+		{
+			for (const TCHAR Char : Lines[LineIndex])
+			{
+				Depth += Char == TEXT('(') ? 1 : (Char == TEXT(')') ? -1 : 0);
+			}
+			if (Depth <= 0) break;
+		}
+
+		// The name is on the first declaration line for types, functions may put the return type on a line of its own
+		Tokens.Reset();
+		const int32 LastDeclarationLine = FMath::Min(LineIndex + 4, Lines.Num() - 1);
+		while (LineIndex < LastDeclarationLine)
+		{
+			LineIndex++;
+			Tokenize(Lines[LineIndex], Tokens);
+			if (Tokens.Num() == 0) continue;
+
+			const FString Name = Kind.GetValue() == ESymbolKind::Function ? GetFunctionName(Tokens) : GetTypeName(Tokens);
+			if (Name.IsEmpty() && Kind.GetValue() == ESymbolKind::Function) continue;
+			if (Name.IsEmpty()) break;
+
+			if (Kind.GetValue() == ESymbolKind::Function)
+			{
+				Symbols.Add({ OwnerName.IsEmpty() ? Name : OwnerName + TEXT("::") + Name, LineIndex + 1, ESymbolKind::Function });
+			}
+			else
+			{
+				Symbols.Add({ Name, LineIndex + 1, Kind.GetValue() });
+				if (Kind.GetValue() != ESymbolKind::Enum)
+				{
+					OwnerName = Kind.GetValue() == ESymbolKind::Interface && Name.StartsWith(TEXT("U"), ESearchCase::CaseSensitive) ? TEXT("I") + Name.Mid(1) : Name;
+				}
+			}
+			break;
+		}
+	}
+	return Symbols;
+}
+
+bool FRiderSymbolIndex::Load(TMap<FString, FFileEntry>& OutFiles)
+{
+	TArray<uint8> Buffer;
+	if (!FFileHelper::LoadFileToArray(Buffer, *GetIndexPath(), FILEREAD_Silent)) return false;
+
+	FMemoryReader Reader(Buffer);
+	uint32 FileMagic = 0;
+	int32 FileFormatVersion = 0;
+	Reader << FileMagic << FileFormatVersion;
+	if (FileMagic != RiderSymbolIndex::Magic || FileFormatVersion != FormatVersion) return false;
+
+	Reader << OutFiles;
+	if (Reader.IsError())
+	{
+		OutFiles.Empty();
+		return false;
+	}
+	return true;
+}
+
+bool FRiderSymbolIndex::Save(TMap<FString, FFileEntry>& Files)
+{
+	TArray<uint8> Buffer;
+	FMemoryWriter Writer(Buffer);
+	uint32 FileMagic = RiderSymbolIndex::Magic;
+	int32 FileFormatVersion = FormatVersion;
+	Writer << FileMagic << FileFormatVersion << Files;
+
+	// Write aside and move into place, so a crash mid-write leaves the previous index intact
+	const FString IndexPath = GetIndexPath();
+	const FString TempPath = IndexPath + TEXT(".") + FGuid::NewGuid().ToString();
+	if (!FFileHelper::SaveArrayToFile(Buffer, *TempPath)) return false;
+	if (!IFileManager::Get().Move(*IndexPath, *TempPath, true, true))
+	{
+		IFileManager::Get().Delete(*TempPath);
+		return false;
+	}
+	return true;
+}
+
+static FAutoConsoleCommand RiderOpenSymbolCommand(
+	TEXT("Rider.OpenSymbol"),
+	TEXT("Opens the declaration of a reflected type or function in the current source code accessor. Args: <Name or Class::Function>"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() == 0) return;
+
+		FRiderSymbolIndex::Initialize();
+		const FRiderSymbolIndex* Index = FRiderSymbolIndex::Get();
+		if (Index == nullptr) return;
+
+		const TOptional<FRiderSymbolIndex::FSymbolLocation> Location = Index->FindBest(Args[0]);
+		if (!Location.IsSet())
+		{
+			UE_LOG(LogRiderSymbolIndex, Display, TEXT("No declaration of %s found%s"), *Args[0], Index->IsReady() ? TEXT("") : TEXT(", the index is still being built"));
+			return;
+		}
+		FModuleManager::LoadModuleChecked<ISourceCodeAccessModule>(TEXT("SourceCodeAccess")).GetAccessor().OpenFileAtLine(Location->File, Location->Line);
+	}));
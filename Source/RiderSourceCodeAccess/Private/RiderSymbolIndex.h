@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Templates/Atomic.h"
+#include "IDirectoryWatcher.h"
+
+/**
+ * Reflected declarations (UCLASS, USTRUCT, UINTERFACE, UENUM and UFUNCTION) in the engine and project headers, by name.
+ * Stored in <Project>/Intermediate/Rider/SymbolIndex.bin with the timestamp and size of every header it was read from,
+ * so a rebuild only parses headers that changed since. Built on the first symbol lookup of a session, over the headers
+ * the source path index found, and kept up to date from directory watcher events.
+ */
+class FRiderSymbolIndex
+{
+public:
+	/** Bump when the file layout or the parser changes, older files are then rebuilt from scratch */
+	static const int32 FormatVersion = 1;
+
+	enum class ESymbolKind : uint8
+	{
+		Class,
+		Struct,
+		Interface,
+		Enum,
+		Function
+	};
+
+	struct FSymbolLocation
+	{
+		FString File;
+		int32 Line = 0;
+		ESymbolKind Kind = ESymbolKind::Class;
+
+		bool operator==(const FSymbolLocation& Other) const { return Line == Other.Line && Kind == Other.Kind && File == Other.File; }
+	};
+
+	/** Must be called on the game thread, starts the background build and the source path index it reads the headers from */
+	static void Initialize();
+	static void Shutdown();
+
+	/** Null until Initialize has been called */
+	static FRiderSymbolIndex* Get();
+
+	static FString GetIndexPath();
+
+	~FRiderSymbolIndex();
+
+	/** Declarations of a type ("AActor") or function ("BeginPlay" or "AActor::BeginPlay"), empty until the index is loaded */
+	TArray<FSymbolLocation> Find(const FString& Name) const;
+
+	/** The declaration to open for Name, the project's when the engine or a plugin declares the same name */
+	TOptional<FSymbolLocation> FindBest(const FString& Name) const;
+
+	bool IsReady() const;
+
+private:
+	struct FSymbol
+	{
+		FString Name;
+		int32 Line = 0;
+		ESymbolKind Kind = ESymbolKind::Class;
+
+		friend FArchive& operator<<(FArchive& Ar, FSymbol& Symbol)
+		{
+			return Ar << Symbol.Name << Symbol.Line << Symbol.Kind;
+		}
+	};
+
+	struct FFileEntry
+	{
+		int64 ModificationTicks = 0;
+		int64 Size = 0;
+		TArray<FSymbol> Symbols;
+
+		friend FArchive& operator<<(FArchive& Ar, FFileEntry& Entry)
+		{
+			return Ar << Entry.ModificationTicks << Entry.Size << Entry.Symbols;
+		}
+	};
+
+	struct FIndexData
+	{
+		TMap<FString, FFileEntry> Files;
+
+		/** Symbol name -> declaration, functions are listed under their plain and their qualified name */
+		TMultiMap<FString, FSymbolLocation> Symbols;
+
+		void SetFile(const FString& Path, FFileEntry&& Entry);
+		void RemoveFile(const FString& Path);
+	};
+
+	static bool IsIndexedFile(const FString& Path);
+	static TArray<FSymbol> ParseFile(const FString& Path);
+	static bool Load(TMap<FString, FFileEntry>& OutFiles);
+	static bool Save(TMap<FString, FFileEntry>& Files);
+
+	void StartBuild();
+	void HandleFilesChanged(const TArray<FFileChangeData>& Changes);
+	void ApplyChanges(const TArray<FFileChangeData>& Changes);
+
+	mutable FRWLock Lock;
+	FIndexData Data;
+	bool bReady = false;
+
+	/** Set by changes since the last save, written back on shutdown */
+	bool bDirty = false;
+
+	/** Changes reported while the background build was still running */
+	TArray<FFileChangeData> PendingChanges;
+
+	TFuture<void> BuildTask;
+	TAtomic<bool> bCancelBuild { false };
+	FDelegateHandle FilesChangedHandle;
+};
@@ -0,0 +1,15 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+// The core ticker became thread-safe and changed its name and handle type in UE5
+#if ENGINE_MAJOR_VERSION >= 5
+typedef FTSTicker FRiderTicker;
+typedef FTSTicker::FDelegateHandle FRiderTickerHandle;
+#else
+typedef FTicker FRiderTicker;
+typedef FDelegateHandle FRiderTickerHandle;
+#endif
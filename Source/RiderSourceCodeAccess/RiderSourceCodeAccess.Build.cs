@@ -17,7 +17,10 @@ namespace UnrealBuildTool.Rules
 					"Json",
 					"Projects",
 					"Slate",
-					"SlateCore"
+					"SlateCore",
+					"DirectoryWatcher",
+					"Sockets",
+					"RiderReloadHandover"
 				}
 			);
 
@@ -28,6 +31,10 @@ namespace UnrealBuildTool.Rules
 				#endif
 				PrivateDependencyModuleNames.Add("UnrealEd");
 				PrivateDependencyModuleNames.Add("GameProjectGeneration");
+				if (Target.Platform == UnrealTargetPlatform.Win64)
+				{
+					PrivateIncludePathModuleNames.Add("LiveCoding");
+				}
 			}
 		}
 	}